@@ -45,6 +45,21 @@ enum class BlendFactor : uint8_t
     SrcAlphaSat,       ///< Multiply the pixel operand by min( As, 1 - Ad ) before applying the blend operation.
 };
 
+/// <summary>
+/// The BlendPipeline identifies a blend mode that has a specialized implementation.
+/// The pipeline is determined once per draw call <see cref="BlendMode::getPipeline"/>
+/// and used as a template argument so that the inner pixel loop does not need to
+/// evaluate the blend factors and blend operations for every pixel.
+/// </summary>
+enum class BlendPipeline : uint8_t
+{
+    Disable,       ///< Blending is disabled. The source color is written to the destination.
+    AlphaDiscard,  ///< The source color replaces the destination color unless it is below the alpha threshold.
+    AlphaBlend,    ///< Alpha blending ( s * As + d * ( 1 - As ) ).
+    Additive,      ///< Additive blending ( s + d ).
+    Generic        ///< Any other combination of blend factors and blend operations.
+};
+
 struct BlendMode
 {
     /// <summary>
@@ -122,6 +137,45 @@ struct BlendMode
     /// <returns></returns>
     constexpr Color Blend( Color srcColor, Color dstColor ) const noexcept;
 
+    /// <summary>
+    /// Perform blending on the source and destination colors using a pipeline
+    /// that is selected at compile time. The pipeline must be the result of
+    /// <see cref="getPipeline"/> for this blend mode.
+    /// </summary>
+    /// <typeparam name="Pipeline">The blend pipeline to use.</typeparam>
+    /// <param name="srcColor">The source color.</param>
+    /// <param name="dstColor">The destination color.</param>
+    /// <returns>The blended color.</returns>
+    template<BlendPipeline Pipeline>
+    constexpr Color Blend( Color srcColor, Color dstColor ) const noexcept;
+
+    /// <summary>
+    /// Determine the specialized blend pipeline that produces the same result as this blend mode.
+    /// </summary>
+    /// <returns>The blend pipeline for this blend mode.</returns>
+    constexpr BlendPipeline getPipeline() const noexcept;
+
+    /// <summary>
+    /// Blend a span of source colors onto a span of destination colors.
+    /// The result is the same as calling <see cref="Blend"/> for each pixel, but
+    /// multiple pixels are blended at a time if SIMD instructions are available.
+    /// </summary>
+    /// <param name="src">The source colors.</param>
+    /// <param name="dst">The destination colors. The result of the blend operation is written back to this span.</param>
+    /// <param name="n">The number of pixels to blend.</param>
+    /// <param name="tint">(Optional) The source colors are multiplied by this color before blending. Default: White.</param>
+    void blendSpan( const Color* src, Color* dst, size_t n, const Color& tint = Color::White ) const noexcept;
+
+    /// <summary>
+    /// Blend a single source color onto a span of destination colors.
+    /// If blending is disabled, the span is filled with the source color. Long spans are filled with
+    /// non-temporal (streaming) stores if SIMD instructions are available, so large fills don't evict the cache.
+    /// </summary>
+    /// <param name="src">The source color.</param>
+    /// <param name="dst">The destination colors. The result of the blend operation is written back to this span.</param>
+    /// <param name="n">The number of pixels to blend.</param>
+    void blendSpan( const Color& src, Color* dst, size_t n ) const noexcept;
+
     static const BlendMode Disable;
     static const BlendMode AlphaDiscard;
     static const BlendMode AlphaBlend;
@@ -256,5 +310,64 @@ constexpr Color BlendMode::Blend( const Color srcColor, const Color dstColor ) c
     return { RGB.channels.r, RGB.channels.g, RGB.channels.b, A };
 }
 
+template<BlendPipeline Pipeline>
+constexpr Color BlendMode::Blend( const Color srcColor, const Color dstColor ) const noexcept
+{
+    if constexpr ( Pipeline == BlendPipeline::Disable )
+    {
+        return srcColor;
+    }
+    else if constexpr ( Pipeline == BlendPipeline::Generic )
+    {
+        return Blend( srcColor, dstColor );
+    }
+    else
+    {
+        if ( srcColor.channels.a < alphaThreshold )
+            return dstColor;
+
+        // The alpha channel of all specialized pipelines is ( As * 1 + Ad * 0 ).
+        if constexpr ( Pipeline == BlendPipeline::AlphaDiscard )
+        {
+            return srcColor;
+        }
+        else if constexpr ( Pipeline == BlendPipeline::AlphaBlend )
+        {
+            const uint8_t a   = srcColor.channels.a;
+            const Color   sA  = { a, a, a, a };
+            const Color   RGB = sA * srcColor + ( Color::White - sA ) * dstColor;
+
+            return { RGB.channels.r, RGB.channels.g, RGB.channels.b, a };
+        }
+        else if constexpr ( Pipeline == BlendPipeline::Additive )
+        {
+            const Color RGB = srcColor + dstColor;
+
+            return { RGB.channels.r, RGB.channels.g, RGB.channels.b, srcColor.channels.a };
+        }
+    }
+}
+
+constexpr BlendPipeline BlendMode::getPipeline() const noexcept
+{
+    if ( !blendEnable )
+        return BlendPipeline::Disable;
+
+    // Only the default alpha blend state ( As * 1 + Ad * 0 ) is specialized.
+    if ( srcAlphaFactor != BlendFactor::One || dstAlphaFactor != BlendFactor::Zero || alphaOp != BlendOperation::Add || blendOp != BlendOperation::Add )
+        return BlendPipeline::Generic;
+
+    if ( srcFactor == BlendFactor::One && dstFactor == BlendFactor::Zero )
+        return BlendPipeline::AlphaDiscard;
+
+    if ( srcFactor == BlendFactor::SrcAlpha && dstFactor == BlendFactor::OneMinusSrcAlpha )
+        return BlendPipeline::AlphaBlend;
+
+    if ( srcFactor == BlendFactor::One && dstFactor == BlendFactor::One )
+        return BlendPipeline::Additive;
+
+    return BlendPipeline::Generic;
+}
+
 }  // namespace graphics
 }  // namespace sr
\ No newline at end of file
@@ -0,0 +1,155 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cassert>
+#include <cstdint>
+#include <memory>
+
+namespace sr
+{
+inline namespace graphics
+{
+/// <summary>
+/// A coverage mask stores one bit per pixel of a color target to mark the pixels that have been
+/// covered by opaque primitives.<br>
+/// Bind the coverage mask to the rasterizer state (Rasterizer::State::coverageMask) and draw the opaque layers
+/// front to back (with BlendMode::Disable or BlendMode::AlphaDiscard). Pixels that are already covered are rejected
+/// before they are sampled, so the layers in the back only cost as much as the pixels that are still visible.
+/// Translucent primitives are neither tested against the coverage mask nor cover any pixels, so they are blended on top
+/// of the opaque layers that were drawn before them.<br>
+/// The coverage mask can be updated from multiple threads (for example, when the tiles of a binning rasterizer are rasterized in parallel).
+/// </summary>
+class CoverageMask
+{
+public:
+    /// <summary>
+    /// Create an empty 0x0 coverage mask.
+    /// </summary>
+    CoverageMask() = default;
+
+    /// <summary>
+    /// Create a coverage mask where no pixel is covered.
+    /// </summary>
+    /// <param name="width">The width (in pixels) of the coverage mask. This should match the width of the color target.</param>
+    /// <param name="height">The height (in pixels) of the coverage mask. This should match the height of the color target.</param>
+    CoverageMask( uint32_t width, uint32_t height );
+
+    CoverageMask( const CoverageMask& )            = delete;
+    CoverageMask& operator=( const CoverageMask& ) = delete;
+
+    CoverageMask( CoverageMask&& ) noexcept            = default;
+    CoverageMask& operator=( CoverageMask&& ) noexcept = default;
+
+    /// <summary>
+    /// Resize the coverage mask. All pixels are uncovered after resizing.
+    /// </summary>
+    /// <param name="width">The new width (in pixels) of the coverage mask.</param>
+    /// <param name="height">The new height (in pixels) of the coverage mask.</param>
+    void resize( uint32_t width, uint32_t height );
+
+    /// <summary>
+    /// Mark all pixels as uncovered. This should be done at the start of every frame.
+    /// </summary>
+    void clear() noexcept;
+
+    uint32_t getWidth() const noexcept
+    {
+        return m_Width;
+    }
+
+    uint32_t getHeight() const noexcept
+    {
+        return m_Height;
+    }
+
+    /// <summary>
+    /// Check if a pixel is covered.
+    /// </summary>
+    /// <param name="x">The x-coordinate of the pixel.</param>
+    /// <param name="y">The y-coordinate of the pixel.</param>
+    /// <returns>true if the pixel is covered by an opaque primitive.</returns>
+    bool isCovered( int x, int y ) const noexcept
+    {
+        assert( x >= 0 && x < static_cast<int>( m_Width ) && y >= 0 && y < static_cast<int>( m_Height ) );
+
+        return ( load( y * m_Stride + ( x >> 6 ) ) >> ( x & 63 ) ) & 1u;
+    }
+
+    /// <summary>
+    /// Mark the pixels [x0, x1] of a row as covered.
+    /// </summary>
+    /// <param name="y">The row of the pixels.</param>
+    /// <param name="x0">The first pixel of the span.</param>
+    /// <param name="x1">The last pixel of the span (inclusive).</param>
+    void cover( int y, int x0, int x1 ) noexcept;
+
+    /// <summary>
+    /// Invoke func( x, n ) for every run of uncovered pixels [x, x + n) in the pixels [x0, x1] of a row.
+    /// Covered pixels are skipped 64 at a time.
+    /// </summary>
+    /// <param name="y">The row of the pixels.</param>
+    /// <param name="x0">The first pixel of the span.</param>
+    /// <param name="x1">The last pixel of the span (inclusive).</param>
+    /// <param name="func">The function to invoke for each run of uncovered pixels.</param>
+    template<typename Func>
+    void forEachUncovered( int y, int x0, int x1, Func&& func ) const;
+
+private:
+    /// <summary>
+    /// Find the first pixel in [x, last] that is covered (or uncovered).
+    /// </summary>
+    /// <returns>The first pixel that matches, or last + 1 if there is none.</returns>
+    int find( int y, int x, int last, bool covered ) const noexcept;
+
+    uint64_t load( size_t i ) const noexcept
+    {
+        return m_Bits[i].load( std::memory_order_relaxed );
+    }
+
+    uint32_t                                 m_Width  = 0;
+    uint32_t                                 m_Height = 0;
+    uint32_t                                 m_Stride = 0;  ///< The number of 64-bit words per row.
+    std::unique_ptr<std::atomic<uint64_t>[]> m_Bits;        ///< One bit per pixel (1 if the pixel is covered).
+};
+
+inline int CoverageMask::find( int y, int x, int last, bool covered ) const noexcept
+{
+    const size_t row = static_cast<size_t>( y ) * m_Stride;
+
+    while ( x <= last )
+    {
+        uint64_t word = load( row + ( x >> 6 ) );
+        if ( !covered )
+            word = ~word;
+
+        // Ignore the pixels before x.
+        word &= ~uint64_t { 0 } << ( x & 63 );
+
+        if ( word )
+            return std::min( ( x & ~63 ) + std::countr_zero( word ), last + 1 );
+
+        x = ( x & ~63 ) + 64;
+    }
+
+    return last + 1;
+}
+
+template<typename Func>
+void CoverageMask::forEachUncovered( int y, int x0, int x1, Func&& func ) const
+{
+    assert( x0 >= 0 && x1 < static_cast<int>( m_Width ) && y >= 0 && y < static_cast<int>( m_Height ) );
+
+    int x = find( y, x0, x1, false );
+    while ( x <= x1 )
+    {
+        const int end = find( y, x, x1, true );
+        func( x, end - x );
+
+        x = find( y, end, x1, false );
+    }
+}
+
+}  // namespace graphics
+}  // namespace sr
@@ -13,6 +13,7 @@ namespace sr
 {
 inline namespace graphics
 {
+class GlyphAtlas;
 
 class Font
 {
@@ -312,6 +313,14 @@ public:
     /// <returns>A reference to the modified font.</returns>
     Font& clearFallbackFonts();
 
+    /// <summary>
+    /// Get the glyph atlas of the font.<br>
+    /// The glyph atlas is recreated when the size, style, outline, or hinting of the font changes.
+    /// Draw calls that still use the previous glyph atlas keep it alive.
+    /// </summary>
+    /// <returns>The glyph atlas for the current size, style, and outline of the font.</returns>
+    std::shared_ptr<GlyphAtlas> getGlyphAtlas() const;
+
     // For internal use.
     TTF_Font* getTTF_FillFont() const
     {
@@ -338,6 +347,10 @@ private:
     std::vector<std::shared_ptr<Font>> m_FallbackFonts;
     FontPtr m_FillFont;
     FontPtr m_OutlineFont;
+
+    // The glyph atlas, and the hash of the font when the glyph atlas was created.
+    mutable std::shared_ptr<GlyphAtlas> m_GlyphAtlas;
+    mutable std::size_t                 m_GlyphAtlasHash = 0;
 };
 }  // namespace graphics
 }  // namespace sr
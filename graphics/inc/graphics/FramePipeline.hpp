@@ -0,0 +1,148 @@
+#pragma once
+
+#include "Image.hpp"
+#include "Rasterizer.hpp"
+
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace sr
+{
+inline namespace graphics
+{
+class Window;
+
+/// <summary>
+/// Pipelined frame rendering.<br>
+/// The game thread records the draw calls of a frame into a command list (see Rasterizer::beginRecording) and submits it to the pipeline.
+/// A render thread rasterizes the submitted frames into a ring of frame buffers. Meanwhile, the game thread presents the previous frame
+/// (and waits for vsync) and then builds the next one. This way, the time to rasterize a frame overlaps with the time to present it,
+/// instead of adding up.<br>
+/// SDL only allows rendering on the main thread, so the frames are presented by the thread that owns the window, and the rasterization
+/// is moved to the render thread instead.<br>
+/// Each submitted frame gets a fence value (1 for the first frame, 2 for the second frame, etc.) that can be used to wait for the frame.
+/// Images, textures, and tile maps that are referenced by a command list must remain valid until its frame is rasterized.
+/// </summary>
+class FramePipeline final
+{
+public:
+    /// <summary>
+    /// The default number of frame buffers (double buffering).
+    /// </summary>
+    static constexpr int DefaultFrameCount = 2;
+
+    /// <summary>
+    /// Create a frame pipeline and start the render thread.
+    /// </summary>
+    /// <param name="width">The width (in pixels) of the frame buffers.</param>
+    /// <param name="height">The height (in pixels) of the frame buffers.</param>
+    /// <param name="frameCount">The number of frame buffers (2 or 3, other values are clamped). This is the maximum number of frames that are in flight (submitted but not presented).</param>
+    FramePipeline( uint32_t width, uint32_t height, int frameCount = DefaultFrameCount );
+
+    /// <summary>
+    /// Wait for the render thread to finish the frame it is rasterizing and stop it.
+    /// </summary>
+    ~FramePipeline();
+
+    FramePipeline( const FramePipeline& )            = delete;
+    FramePipeline( FramePipeline&& )                 = delete;
+    FramePipeline& operator=( const FramePipeline& ) = delete;
+    FramePipeline& operator=( FramePipeline&& )      = delete;
+
+    /// <summary>
+    /// Submit the draw calls of a frame to the render thread.<br>
+    /// The draw calls are replayed to the frame buffer of the frame (with binning), regardless of the color target they were recorded with.
+    /// If all frame buffers are in flight, this blocks until the oldest frame is presented.
+    /// </summary>
+    /// <param name="commandList">The draw calls of the frame.</param>
+    /// <returns>The fence value of the frame.</returns>
+    uint64_t submit( Rasterizer::CommandList commandList );
+
+    /// <summary>
+    /// Wait for a frame to be rasterized, present it to the window, and release the frame buffers of this frame and all frames before it.<br>
+    /// To overlap the rasterization with presenting, present the previous frame after submitting the next one:
+    /// <code>
+    /// uint64_t fence = pipeline.submit( std::move( commandList ) );
+    /// pipeline.present( window, fence - 1 );
+    /// </code>
+    /// </summary>
+    /// <param name="window">The window to present the frame to.</param>
+    /// <param name="fence">The fence value of the frame to present. Nothing is presented if the frame was already presented (or the fence value is 0).</param>
+    void present( Window& window, uint64_t fence );
+
+    /// <summary>
+    /// Get the fence value of the last submitted frame.
+    /// </summary>
+    uint64_t getSubmittedFence() const noexcept;
+
+    /// <summary>
+    /// Get the fence value of the last frame that was rasterized.
+    /// </summary>
+    uint64_t getCompletedFence() const noexcept;
+
+    /// <summary>
+    /// Check if a frame was rasterized.
+    /// </summary>
+    /// <param name="fence">The fence value of the frame.</param>
+    /// <returns>true if the frame was rasterized.</returns>
+    bool isComplete( uint64_t fence ) const noexcept
+    {
+        return getCompletedFence() >= fence;
+    }
+
+    /// <summary>
+    /// Block until a frame was rasterized.
+    /// </summary>
+    /// <param name="fence">The fence value of the frame to wait for.</param>
+    void wait( uint64_t fence ) const;
+
+    /// <summary>
+    /// Block until all submitted frames were rasterized (for example, before releasing resources that are referenced by the command lists).
+    /// </summary>
+    void waitIdle() const
+    {
+        wait( getSubmittedFence() );
+    }
+
+    /// <summary>
+    /// Get the frame buffer of a frame. The frame buffer is only valid until the frame is presented.
+    /// </summary>
+    /// <param name="fence">The fence value of the frame.</param>
+    /// <returns>The frame buffer of the frame.</returns>
+    const Image& getFrame( uint64_t fence ) const noexcept;
+
+    int getFrameCount() const noexcept
+    {
+        return static_cast<int>( m_Frames.size() );
+    }
+
+private:
+    /// <summary>
+    /// The render thread.
+    /// </summary>
+    void run();
+
+    struct Frame
+    {
+        Image                   image;     ///< The frame buffer.
+        Rasterizer::CommandList commands;  ///< The draw calls of the frame.
+    };
+
+    std::vector<Frame> m_Frames;
+
+    mutable std::mutex              m_Mutex;
+    mutable std::condition_variable m_Condition;
+
+    uint64_t m_Submitted = 0;      ///< The fence value of the last submitted frame.
+    uint64_t m_Completed = 0;      ///< The fence value of the last rasterized frame.
+    uint64_t m_Presented = 0;      ///< The fence value of the last presented frame (its frame buffer can be reused).
+    bool     m_Stop      = false;  ///< Stop the render thread.
+
+    std::thread m_Thread;
+};
+
+}  // namespace graphics
+}  // namespace sr
@@ -0,0 +1,105 @@
+#pragma once
+
+#include "Image.hpp"
+
+#include <math/Rect.hpp>
+
+#include <glm/vec2.hpp>
+
+#include <cstdint>
+#include <memory>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+struct TTF_Font;
+
+namespace sr
+{
+inline namespace graphics
+{
+/// <summary>
+/// A cache of the rendered glyphs of a font (for a specific size, style, and outline).<br>
+/// Glyphs are rendered in white the first time they are used, and packed into atlas pages (using stb_rect_pack).
+/// Rasterizer::drawText draws text as quads from the atlas pages, tinted with the text color,
+/// so drawing dynamic text (for example, an FPS counter) only costs a few cached glyph blits.<br>
+/// Use Font::getGlyphAtlas to get the glyph atlas of a font.
+/// </summary>
+class GlyphAtlas
+{
+public:
+    /// <summary>
+    /// The width and height (in pixels) of an atlas page.
+    /// </summary>
+    static constexpr int PageSize = 512;
+
+    /// <summary>
+    /// A glyph quad of a line of text.
+    /// </summary>
+    struct Quad
+    {
+        const Image* page = nullptr;   ///< The atlas page that contains the glyph.
+        math::RectI  rect;             ///< The rectangle of the glyph on the atlas page.
+        glm::ivec2   position;         ///< The top-left corner of the quad (in pixels).
+        bool         outline = false;  ///< true if this is a glyph of the outline font.
+    };
+
+    /// <summary>
+    /// Create an empty glyph atlas.
+    /// </summary>
+    /// <param name="fillFont">The font that is used to render the fill glyphs.</param>
+    /// <param name="outlineFont">The font that is used to render the outline glyphs.</param>
+    GlyphAtlas( TTF_Font* fillFont, TTF_Font* outlineFont );
+    ~GlyphAtlas();
+
+    GlyphAtlas( const GlyphAtlas& )            = delete;
+    GlyphAtlas& operator=( const GlyphAtlas& ) = delete;
+
+    /// <summary>
+    /// Lay out a string as glyph quads. Glyphs that are not in the atlas yet are rendered and added to the atlas.<br>
+    /// The outline quads (if the font has an outline) come before the fill quads, so the outline is drawn behind the text.
+    /// </summary>
+    /// <param name="text">The UTF-8 encoded text. Lines are separated by newline characters.</param>
+    /// <param name="x">The x-coordinate of the top-left corner of the text.</param>
+    /// <param name="y">The y-coordinate of the top-left corner of the text.</param>
+    /// <returns>The glyph quads of the text.</returns>
+    std::vector<Quad> layout( std::string_view text, int x, int y );
+
+    /// <summary>
+    /// Get the number of atlas pages.
+    /// </summary>
+    size_t getPageCount() const noexcept
+    {
+        return m_Pages.size();
+    }
+
+private:
+    struct Page;
+
+    struct Glyph
+    {
+        const Image* page = nullptr;  ///< The atlas page of the glyph (null if the glyph doesn't have any pixels).
+        math::RectI  rect;            ///< The rectangle of the glyph on the atlas page.
+        int          advance = 0;     ///< The horizontal advance (in pixels).
+    };
+
+    /// <summary>
+    /// Get a glyph from the atlas, or render it and add it to the atlas.
+    /// </summary>
+    const Glyph& getGlyph( uint32_t codepoint, bool outline );
+
+    /// <summary>
+    /// Render a glyph and pack it into an atlas page.
+    /// </summary>
+    Glyph addGlyph( uint32_t codepoint, bool outline );
+
+    TTF_Font* m_FillFont    = nullptr;
+    TTF_Font* m_OutlineFont = nullptr;
+
+    std::vector<std::unique_ptr<Page>> m_Pages;
+
+    // The glyphs in the atlas. The key is the codepoint (the outline glyphs have bit 32 set).
+    std::unordered_map<uint64_t, Glyph> m_Glyphs;
+};
+}  // namespace graphics
+}  // namespace sr
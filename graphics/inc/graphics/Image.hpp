@@ -5,10 +5,14 @@
 #include "aligned_unique_ptr.hpp"
 
 #include <math/AABB.hpp>
+#include <math/Math.hpp>
 
+#include <atomic>
 #include <filesystem>
+#include <memory>
 #include <optional>
 #include <utility>
+#include <vector>
 
 namespace sr
 {
@@ -48,6 +52,24 @@ struct Image final
     /// <param name="color">Optional color to fill the texture with.</param>
     Image( uint32_t width, uint32_t height, std::optional<Color> color = {} );
 
+    /// <summary>
+    /// Create an image view over external pixels (for example, the locked pixels of a streaming texture <see cref="Window::acquireFrame"/>).
+    /// The image doesn't own the pixels, and the pixels must stay valid while the image is used.
+    /// Resizing an image view allocates a pixel buffer that is owned by the image.
+    /// </summary>
+    /// <param name="pixels">The pixels of the image (width * height pixels without padding between the rows).</param>
+    /// <param name="width">The image width (in pixels).</param>
+    /// <param name="height">The image height (in pixels).</param>
+    Image( Color* pixels, uint32_t width, uint32_t height );
+
+    /// <summary>
+    /// Point an image view to other external pixels of the same size (for example, when a streaming texture is locked again).
+    /// The dirty tiles and the tiles of the lazy clear are reused instead of being allocated again. A pending lazy clear is
+    /// discarded and the entire image is marked as dirty, since the contents of the new pixels are undefined.
+    /// </summary>
+    /// <param name="pixels">The pixels of the image (width * height pixels without padding between the rows).</param>
+    void setView( Color* pixels ) noexcept;
+
     /// <summary>
     /// Copy another image to this one.
     /// </summary>
@@ -70,7 +92,7 @@ struct Image final
     const Color& operator[]( size_t i ) const
     {
         assert( std::cmp_less(i ,m_Width * m_Height) );
-        return m_Pixels[i];
+        return m_Data[i];
     }
 
     /// <summary>
@@ -81,7 +103,7 @@ struct Image final
     Color& operator[]( size_t i )
     {
         assert( std::cmp_less( i , m_Width * m_Height ) );
-        return m_Pixels[i];
+        return m_Data[i];
     }
 
     const Color& operator[]( size_t x, size_t y ) const
@@ -89,7 +111,7 @@ struct Image final
         assert( std::cmp_less( x , m_Width ) );
         assert( std::cmp_less( y , m_Height ) );
 
-        return m_Pixels[y * m_Width + x];
+        return m_Data[y * m_Width + x];
     }
 
     Color& operator[]( size_t x, size_t y )
@@ -97,7 +119,7 @@ struct Image final
         assert( std::cmp_less( x , m_Width ) );
         assert( std::cmp_less( y , m_Height ) );
 
-        return m_Pixels[y * m_Width + x];
+        return m_Data[y * m_Width + x];
     }
 
     /// <summary>
@@ -111,7 +133,7 @@ struct Image final
         assert( std::cmp_less( x , m_Width ) );
         assert( std::cmp_less( y , m_Height ) );
 
-        return m_Pixels[y * m_Width + x];
+        return m_Data[y * m_Width + x];
     }
 
     /// <summary>
@@ -125,7 +147,7 @@ struct Image final
         assert( std::cmp_less( x , m_Width ) );
         assert( std::cmp_less( y , m_Height ) );
 
-        return m_Pixels[y * m_Width + x];
+        return m_Data[y * m_Width + x];
     }
 
     /// <summary>
@@ -133,7 +155,15 @@ struct Image final
     /// </summary>
     explicit operator bool() const noexcept
     {
-        return m_Pixels != nullptr;
+        return m_Data != nullptr;
+    }
+
+    /// <summary>
+    /// Check if the image is a view over external pixels.
+    /// </summary>
+    bool isView() const noexcept
+    {
+        return m_Data != nullptr && m_Pixels == nullptr;
     }
 
     /// <summary>
@@ -145,6 +175,50 @@ struct Image final
     /// <returns>The color of the texel at the given UV coordinates.</returns>
     const Color& sample( int u, int v, const SamplerState& samplerState = SamplerState{}) const noexcept;
 
+    /// <summary>
+    /// Sample the image at integer coordinates using an address mode that is known at compile time.
+    /// The address mode of the sampler state is ignored.
+    /// </summary>
+    /// <typeparam name="Mode">The address mode to apply to out-of-range texture coordinates.</typeparam>
+    /// <param name="u">The U texture coordinate.</param>
+    /// <param name="v">The V texture coordinate.</param>
+    /// <param name="samplerState">Provides the border color used by <see cref="AddressMode::Border"/>.</param>
+    /// <returns>The color of the texel at the given UV coordinates.</returns>
+    template<AddressMode Mode>
+    const Color& sample( int u, int v, const SamplerState& samplerState ) const noexcept
+    {
+        const int w = m_Width;
+        const int h = m_Height;
+
+        if constexpr ( Mode == AddressMode::Wrap )
+        {
+            // Optimized wrap using bitwise operations for power-of-2, fast mod otherwise
+            u = widthInfo.isPowerOf2 ? u & widthInfo.mask : math::fast_mod_signed( u, w );
+            v = heightInfo.isPowerOf2 ? v & heightInfo.mask : math::fast_mod_signed( v, h );
+        }
+        else if constexpr ( Mode == AddressMode::Mirror )
+        {
+            u = math::mirror_coord( u, w );
+            v = math::mirror_coord( v, h );
+        }
+        else if constexpr ( Mode == AddressMode::Clamp )
+        {
+            // Branchless clamping - often faster than std::clamp due to avoided branches
+            u = u < 0 ? 0 : ( u >= w ? w - 1 : u );
+            v = v < 0 ? 0 : ( v >= h ? h - 1 : v );
+        }
+        else if constexpr ( Mode == AddressMode::Border )
+        {
+            if ( u < 0 || u >= w || v < 0 || v >= h )
+                return samplerState.borderColor;
+        }
+
+        assert( u >= 0 && u < w );
+        assert( v >= 0 && v < h );
+
+        return m_Data[v * m_Width + u];
+    }
+
     /// <summary>
     /// Sample the image at integer coordinates.
     /// </summary>
@@ -185,6 +259,26 @@ struct Image final
         return sample( uv.x, uv.y, samplerState );
     }
 
+    /// <summary>
+    /// Sample the image using an address mode that is known at compile time.
+    /// </summary>
+    /// <typeparam name="Mode">The address mode to apply to out-of-range texture coordinates.</typeparam>
+    /// <param name="u">The U texture coordinate.</param>
+    /// <param name="v">The V texture coordinate.</param>
+    /// <param name="samplerState">Determines if the texture coordinates are normalized and provides the border color.</param>
+    /// <returns>The color of the texel at the given UV texture coordinates.</returns>
+    template<AddressMode Mode>
+    const Color& sample( float u, float v, const SamplerState& samplerState ) const noexcept
+    {
+        if ( samplerState.normalizedCoordinates )
+        {
+            u = u * static_cast<float>( m_Width - 1 ) + 0.5f;   // NOLINT(bugprone-incorrect-roundings)
+            v = v * static_cast<float>( m_Height - 1 ) + 0.5f;  // NOLINT(bugprone-incorrect-roundings)
+        }
+
+        return sample<Mode>( static_cast<int>( u ), static_cast<int>( v ), samplerState );
+    }
+
     /// <summary>
     /// Plot a single pixel to the image. Out-of-bounds coordinates are discarded.
     /// </summary>
@@ -192,7 +286,9 @@ struct Image final
     /// <param name="y">The y-coordinate to plot.</param>
     /// <param name="src">The source color of the pixel to plot.</param>
     /// <param name="blendMode">(Optional) The blend mode to apply. Default: No blending.</param>
-    template<bool BoundsCheck = true, bool Blending = true>
+    /// <typeparam name="Pipeline">(Optional) The specialized blend pipeline for the blend mode <see cref="BlendMode::getPipeline"/>.</typeparam>
+    /// <typeparam name="MarkDirty">(Optional) Mark the pixel as dirty. The rasterizer marks the region of a draw call as dirty before plotting its pixels.</typeparam>
+    template<bool BoundsCheck = true, bool Blending = true, BlendPipeline Pipeline = BlendPipeline::Generic, bool MarkDirty = true>
     void plot( uint32_t x, uint32_t y, const Color& src, const BlendMode& blendMode = BlendMode {} ) noexcept
     {
         if constexpr ( BoundsCheck )
@@ -206,10 +302,13 @@ struct Image final
             assert( std::cmp_less( y, m_Height ) );
         }
 
-        Color& dst = m_Pixels[y * m_Width + x];
+        if constexpr ( MarkDirty )
+            markDirty( static_cast<int>( x ), static_cast<int>( y ) );
+
+        Color& dst = m_Data[y * m_Width + x];
         if constexpr ( Blending )
         {
-            dst = blendMode.Blend( src, dst );
+            dst = blendMode.Blend<Pipeline>( src, dst );
         }
         else
         {
@@ -234,6 +333,100 @@ struct Image final
     /// <param name="color">The color to clear the image to.</param>
     void clear( const Color& color ) noexcept;
 
+    /// <summary>
+    /// The width and height (in pixels) of the tiles that are cleared lazily by <see cref="fastClear"/>.
+    /// </summary>
+    static constexpr int ClearTileSize = 64;
+
+    /// <summary>
+    /// Clear the image lazily.<br>
+    /// Instead of writing every pixel, the clear color is recorded for every tile of the image. The pixels of a tile are
+    /// cleared the first time the rasterizer draws to the tile, and the tiles that are never drawn to are cleared when
+    /// the image is resolved. Window::present and Image::save resolve the image, so frames where an opaque background
+    /// covers most of the image skip most of the clear.<br>
+    /// Call <see cref="resolveClear"/> before accessing the pixels directly (for example, with data() or plot()).
+    /// </summary>
+    /// <param name="color">The color to clear the image to.</param>
+    void fastClear( const Color& color );
+
+    /// <summary>
+    /// Clear the tiles that overlap a region of the image and are still pending from a call to <see cref="fastClear"/>.
+    /// This can be called from multiple threads.
+    /// </summary>
+    /// <param name="aabb">The region of the image that is about to be accessed.</param>
+    void resolveClear( const AABB& aabb ) const
+    {
+        if ( m_LazyClear )
+            resolveTiles( aabb, nullptr );
+    }
+
+    /// <summary>
+    /// Clear the tiles that overlap a region of the image and are still pending from a call to <see cref="fastClear"/>,
+    /// except for the tiles that are completely inside of the overwritten region. Every pixel of these tiles is about
+    /// to be replaced (for example, by an opaque blit), so they are marked as cleared without writing the clear color.
+    /// This can be called from multiple threads, as long as no other thread accesses the overwritten region.
+    /// </summary>
+    /// <param name="aabb">The region of the image that is about to be accessed.</param>
+    /// <param name="overwritten">The region of the image where every pixel is about to be replaced.</param>
+    void resolveClear( const AABB& aabb, const AABB& overwritten ) const
+    {
+        if ( m_LazyClear )
+            resolveTiles( aabb, &overwritten );
+    }
+
+    /// <summary>
+    /// Clear all tiles that are still pending from a call to <see cref="fastClear"/>.
+    /// </summary>
+    void resolveClear() const
+    {
+        if ( m_LazyClear )
+            resolveTiles( m_AABB, nullptr );
+    }
+
+    /// <summary>
+    /// The width and height (in pixels) of the tiles that are tracked for changes <see cref="markDirty"/>.
+    /// </summary>
+    static constexpr int DirtyTileSize = 32;
+
+    /// <summary>
+    /// Mark a pixel as dirty (changed since the image was last presented).
+    /// </summary>
+    /// <param name="x">The x-coordinate of the pixel.</param>
+    /// <param name="y">The y-coordinate of the pixel.</param>
+    void markDirty( int x, int y ) noexcept
+    {
+        assert( x >= 0 && x < m_Width );
+        assert( y >= 0 && y < m_Height );
+
+        std::atomic<uint8_t>& tile = m_DirtyTiles[( y / DirtyTileSize ) * m_DirtyColumns + x / DirtyTileSize];
+        if ( !tile.load( std::memory_order_relaxed ) )
+            tile.store( 1, std::memory_order_relaxed );
+    }
+
+    /// <summary>
+    /// Mark a region of the image as dirty (changed since the image was last presented).<br>
+    /// The rasterizer, plot, and clear mark the pixels they write to. Call this after writing to the pixels directly
+    /// (for example, through data()). This can be called from multiple threads.
+    /// </summary>
+    /// <param name="aabb">The region of the image that was changed.</param>
+    void markDirty( const AABB& aabb ) noexcept;
+
+    /// <summary>
+    /// Mark the entire image as dirty.
+    /// </summary>
+    void markDirty() noexcept
+    {
+        markDirty( m_AABB );
+    }
+
+    /// <summary>
+    /// Get the regions of the image that are dirty, and mark the image as clean.
+    /// The dirty tiles are merged into rectangles (runs of tiles in a row, extended over the rows that have the same run).
+    /// Window::present only uploads these regions of the image.
+    /// </summary>
+    /// <returns>The dirty regions of the image.</returns>
+    std::vector<math::RectI> takeDirtyRects() const;
+
     /// <summary>
     /// Resize this image.
     /// Note: This function does nothing if the image is already the requested size.
@@ -284,7 +477,7 @@ struct Image final
     /// <returns>A pointer to the pixel buffer of the image.</returns>
     Color* data() noexcept
     {
-        return m_Pixels.get();
+        return m_Data;
     }
 
     /// <summary>
@@ -293,10 +486,28 @@ struct Image final
     /// <returns>A read-only pointer to the pixel buffer of the image.</returns>
     const Color* data() const noexcept
     {
-        return m_Pixels.get();
+        return m_Data;
     }
 
 private:
+    struct LazyClear;
+
+    /// <summary>
+    /// Clear the pending tiles that overlap the region.
+    /// Pending tiles that are completely inside of the overwritten region (if any) are resolved without clearing them.
+    /// </summary>
+    void resolveTiles( const AABB& aabb, const AABB* overwritten ) const;
+
+    /// <summary>
+    /// Discard the pending tiles of a lazy clear (when every pixel is overwritten).
+    /// </summary>
+    void cancelClear() noexcept;
+
+    /// <summary>
+    /// Set the size of the image (after the pixels were replaced).
+    /// </summary>
+    void setSize( uint32_t width, uint32_t height );
+
     // Precompute power-of-2 check results to avoid repeated computation
     struct AddressingInfo
     {
@@ -330,9 +541,34 @@ private:
     int m_Height = 0;
 
     /// <summary>
-    /// The pixel buffer.
+    /// The pixel buffer (null if the image is a view over external pixels).
     /// </summary>
     aligned_unique_ptr<Color[]> m_Pixels;
+
+    /// <summary>
+    /// The pixels of the image (either the pixel buffer or the external pixels of an image view).
+    /// </summary>
+    Color* m_Data = nullptr;
+
+    /// <summary>
+    /// The clear color and the pending tiles of a lazy clear (only valid after fastClear).
+    /// </summary>
+    std::unique_ptr<LazyClear> m_LazyClear;
+
+    /// <summary>
+    /// One flag per tile of DirtyTileSize x DirtyTileSize pixels that is set if the tile was changed.
+    /// </summary>
+    std::unique_ptr<std::atomic<uint8_t>[]> m_DirtyTiles;
+
+    /// <summary>
+    /// The number of columns of dirty tiles.
+    /// </summary>
+    int m_DirtyColumns = 0;
+
+    /// <summary>
+    /// The number of rows of dirty tiles.
+    /// </summary>
+    int m_DirtyRows = 0;
 };
 }  // namespace graphics
 }  // namespace sr
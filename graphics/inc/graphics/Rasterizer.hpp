@@ -2,11 +2,13 @@
 
 #include "BlendMode.hpp"
 #include "Color.hpp"
+#include "CoverageMask.hpp"
 #include "Font.hpp"
 #include "Image.hpp"
 #include "SamplerState.hpp"
 #include "Sprite.hpp"
 #include "Text.hpp"
+#include "ThreadPool.hpp"
 #include "TileMap.hpp"
 #include "Vertex.hpp"
 
@@ -14,6 +16,12 @@
 #include <math/Transform2D.hpp>
 #include <math/Viewport.hpp>
 
+#include <functional>
+#include <memory>
+#include <optional>
+#include <span>
+#include <vector>
+
 struct TTF_TextEngine;
 
 namespace sr
@@ -29,22 +37,192 @@ public:
     /// </summary>
     struct State
     {
-        Color     color                 = Color::White;     ///< Blend color.
-        Color     outlineColor          = Color::Black;     ///< Outline color used for drawing text.
-        FillMode  fillMode              = FillMode::Solid;  ///< Primitive filling mode (solid or wireframe).
-        CullMode  cullMode              = CullMode::Back;   ///< Determines which triangles are not drawn.
-        bool      frontCounterClockwise = true;             ///< If true, triangles are considered front-facing if their winding order is counter-clockwise.
-        BlendMode blendMode;                                ///< Determines how pixels are blended together on the render target.
-        Image*    colorTarget = nullptr;                    ///< The image to draw to.
-        Viewport  viewport;                                 ///< Viewport can be used for split-screen drawing.
+        Color         color                 = Color::White;     ///< Blend color.
+        Color         outlineColor          = Color::Black;     ///< Outline color used for drawing text.
+        FillMode      fillMode              = FillMode::Solid;  ///< Primitive filling mode (solid or wireframe).
+        CullMode      cullMode              = CullMode::Back;   ///< Determines which triangles are not drawn.
+        bool          frontCounterClockwise = true;             ///< If true, triangles are considered front-facing if their winding order is counter-clockwise.
+        BlendMode     blendMode;                                ///< Determines how pixels are blended together on the render target.
+        Image*        colorTarget  = nullptr;                   ///< The image to draw to.
+        CoverageMask* coverageMask = nullptr;                   ///< (optional) Rejects the pixels of opaque images, sprites, and tile maps that are behind opaque pixels that were drawn before them. Must be the same size as the color target.
+        Viewport      viewport;                                 ///< Viewport can be used for split-screen drawing.
     } state;
 
+    /// <summary>
+    /// A list of recorded draw calls.<br>
+    /// Use Rasterizer::beginRecording to record draw calls into a command list, and Rasterizer::execute to replay them.
+    /// Each command stores a copy of the rasterizer state that was used to record it, so a command list can be
+    /// replayed any number of times, to any color target, without rebuilding it.<br>
+    /// A command list only defers the draw calls: apart from culling the draw calls that fall outside of the color target,
+    /// the commands are not sorted or merged when they are replayed (this would change the blend order), so replaying a
+    /// command list costs the same as issuing the draw calls again.<br>
+    /// Images, textures, and tile maps that are referenced by the recorded draw calls must remain valid while the command list is in use.
+    /// </summary>
+    class CommandList
+    {
+    public:
+        /// <summary>
+        /// Remove all commands from the command list.
+        /// </summary>
+        void clear() noexcept
+        {
+            m_Commands.clear();
+        }
+
+        /// <summary>
+        /// Check if the command list is empty.
+        /// </summary>
+        /// <returns>true if no draw calls have been recorded.</returns>
+        bool empty() const noexcept
+        {
+            return m_Commands.empty();
+        }
+
+        /// <summary>
+        /// Get the number of recorded draw calls.
+        /// </summary>
+        size_t size() const noexcept
+        {
+            return m_Commands.size();
+        }
+
+    private:
+        friend class Rasterizer;
+
+        struct Command
+        {
+            State                                    state;   ///< The rasterizer state when the draw call was recorded.
+            math::AABB                               bounds;  ///< The screen-space bounds of the draw call.
+            std::function<void( const Rasterizer& )> draw;    ///< Replays the draw call.
+        };
+
+        std::vector<Command> m_Commands;
+    };
+
+    /// <summary>
+    /// The default size (in pixels) of the screen tiles used for binned rendering.
+    /// </summary>
+    static constexpr int DefaultTileSize = 64;
+
+    Rasterizer();
+    ~Rasterizer();
+
+    /// <summary>
+    /// Copy the rasterizer (usually to draw with a modified state).<br>
+    /// The copy shares the bins and the command list that is being recorded to with the original,
+    /// so draw calls of the copy end up in the same frame, in submission order.
+    /// </summary>
+    Rasterizer( const Rasterizer& );
+    Rasterizer& operator=( const Rasterizer& );
+
+    Rasterizer( Rasterizer&& ) noexcept;
+    Rasterizer& operator=( Rasterizer&& ) noexcept;
+
+    /// <summary>
+    /// Begin binned rendering.<br>
+    /// While binning, draw calls are not executed immediately. Instead, each draw call is recorded together
+    /// with a copy of the current rasterizer state and sorted into the screen tiles that its bounding box overlaps.
+    /// When the bins are flushed, the tiles are rasterized in parallel. Each tile replays its draw calls in
+    /// submission order, so the blend order is the same as in immediate mode.<br>
+    /// Submit draw calls from a single thread while binning: draw calls that are submitted concurrently are binned
+    /// in an unspecified order, which may change from frame to frame.<br>
+    /// Images, textures, and tile maps that are referenced by a draw call must remain valid until the bins are flushed.
+    /// </summary>
+    /// <param name="tileSize">The width and height (in pixels) of a screen tile. Default: 64.</param>
+    void beginBinning( int tileSize = DefaultTileSize );
+
+    /// <summary>
+    /// Flush all binned draw calls and return to immediate mode rendering.
+    /// </summary>
+    void endBinning();
+
+    /// <summary>
+    /// Rasterize all draw calls that have been binned since the last flush.
+    /// Make sure to flush the rasterizer before presenting or saving the color target.
+    /// </summary>
+    void flush() const;
+
+    /// <summary>
+    /// Check if the rasterizer is currently binning draw calls.
+    /// </summary>
+    /// <returns>true if draw calls are deferred until the next flush.</returns>
+    bool isBinning() const noexcept
+    {
+        return m_Binner != nullptr;
+    }
+
+    /// <summary>
+    /// Begin recording draw calls into a command list.<br>
+    /// While recording, draw calls are not executed but are appended to the command list.
+    /// Recording is not thread-safe, so draw calls must be submitted from a single thread.
+    /// </summary>
+    /// <param name="commandList">The command list to record to.</param>
+    void beginRecording( CommandList& commandList );
+
+    /// <summary>
+    /// Stop recording draw calls.
+    /// </summary>
+    void endRecording();
+
+    /// <summary>
+    /// Check if the rasterizer is currently recording draw calls into a command list.
+    /// </summary>
+    /// <returns>true if draw calls are recorded instead of executed.</returns>
+    bool isRecording() const noexcept
+    {
+        return m_CommandList != nullptr;
+    }
+
+    /// <summary>
+    /// Call a function that submits draw calls to this rasterizer for each element of a range.<br>
+    /// In immediate mode, the elements are processed in parallel (see parallelForEach).
+    /// Binned and recorded draw calls are replayed in submission order, so while binning or recording, the elements are
+    /// processed serially and the draw calls are replayed in the order of the range. The binner still rasterizes the
+    /// screen tiles in parallel when the bins are flushed.
+    /// </summary>
+    /// <param name="range">The elements to process.</param>
+    /// <param name="function">The function that is called for each element.</param>
+    template<std::ranges::random_access_range Range, typename Function>
+    void forEachDrawCall( Range&& range, Function&& function ) const
+    {
+        if ( isBinning() || isRecording() )
+        {
+            for ( auto&& element: range )
+                function( element );
+        }
+        else
+        {
+            parallelForEach( std::forward<Range>( range ), std::forward<Function>( function ) );
+        }
+    }
+
+    /// <summary>
+    /// Replay the draw calls in a command list.<br>
+    /// Each draw call uses the rasterizer state that was captured when it was recorded.
+    /// If a color target is set on this rasterizer, the draw calls are replayed to that color target instead.
+    /// Draw calls that fall completely outside of the color target are culled.<br>
+    /// The draw calls are binned if binning is enabled (the command list must remain valid until the bins are flushed),
+    /// or appended to the current command list if this rasterizer is recording.
+    /// A command list cannot be replayed into itself.
+    /// </summary>
+    /// <param name="commandList">The command list to replay.</param>
+    void execute( const CommandList& commandList ) const;
+
     /// <summary>
     /// Clear the color target.
     /// </summary>
     /// <param name="color">The color to clear the color target to. Default: Black.</param>
     void clear( std::optional<Color> color = {} ) const;
 
+    /// <summary>
+    /// Clear the color target lazily (see Image::fastClear).<br>
+    /// Only the clear color is recorded for each tile of the color target. The pixels of a tile are cleared the first time
+    /// the rasterizer draws to the tile, and the remaining tiles are cleared when the color target is presented or saved.<br>
+    /// Any binned draw calls are flushed first. While recording a command list, a regular clear is recorded.
+    /// </summary>
+    /// <param name="color">The color to clear the color target to. Default: The color of the rasterizer state.</param>
+    void fastClear( std::optional<Color> color = {} ) const;
+
     /// <summary>
     /// Draws a line from (x0, y0) to (x1, y1) using the current rasterizer state.<br>
     /// Required state:
@@ -120,6 +298,32 @@ public:
         drawLine( line.p0.x, line.p0.y, line.p1.x, line.p1.y );
     }
 
+    /// <summary>
+    /// Draw a list of lines using the current rasterizer state, where line i goes from points[i * 2] to points[i * 2 + 1].<br>
+    /// The lines are culled against the viewport in bulk (with integer outcodes), the blend pipeline is selected once
+    /// per batch, and the pixels are written through row pointers. The result is the same as calling drawLine for each line.<br>
+    /// Required state:
+    /// - color
+    /// - blendMode
+    /// - colorTarget
+    /// - viewport
+    /// </summary>
+    /// <param name="points">The end points of the lines.</param>
+    void drawLines( std::span<const glm::vec2> points ) const;
+
+    /// <summary>
+    /// Draw a line strip through the points using the current rasterizer state.<br>
+    /// The result is the same as calling drawLine for each pair of consecutive points.
+    /// Required state:
+    /// - color
+    /// - blendMode
+    /// - colorTarget
+    /// - viewport
+    /// </summary>
+    /// <param name="points">The points of the polyline.</param>
+    /// <param name="closed">(optional) If true, the last point is connected to the first point. Default: false.</param>
+    void drawPolyline( std::span<const glm::vec2> points, bool closed = false ) const;
+
     void drawCircle( int x, int y, int r ) const;
 
     void drawCircle( const glm::ivec2& center, int radius ) const
@@ -142,6 +346,54 @@ public:
         drawCircle( sphere.center.x, sphere.center.y, sphere.radius );
     }
 
+    /// <summary>
+    /// Draw a batch of circles using the current rasterizer state.<br>
+    /// The circles are culled against the viewport in bulk, and the rows of each circle are looked up in a span table
+    /// that is computed once per radius. The batch is rasterized in parallel screen tiles (or binned per tile while binning),
+    /// in submission order, so the result is the same as calling drawCircle for each circle.<br>
+    /// Required state:
+    /// - color (if no colors are specified)
+    /// - fillMode
+    /// - blendMode
+    /// - colorTarget
+    /// - viewport
+    /// </summary>
+    /// <param name="circles">The circles to draw.</param>
+    /// <param name="colors">(optional) The color of each circle. If empty, the color of the rasterizer state is used.</param>
+    void drawCircles( std::span<const Circle> circles, std::span<const Color> colors = {} ) const;
+
+    /// <summary>
+    /// Draw a batch of points (one pixel per point) using the current rasterizer state.<br>
+    /// Required state:
+    /// - color (if no colors are specified)
+    /// - blendMode
+    /// - colorTarget
+    /// - viewport
+    /// </summary>
+    /// <param name="points">The points to draw.</param>
+    /// <param name="colors">(optional) The color of each point. If empty, the color of the rasterizer state is used.</param>
+    void drawPoints( std::span<const glm::vec2> points, std::span<const Color> colors = {} ) const;
+
+    /// <summary>
+    /// Draw an axis-aligned ellipse using the current rasterizer state.<br>
+    /// Required state:
+    /// - color
+    /// - fillMode
+    /// - blendMode
+    /// - colorTarget
+    /// - viewport
+    /// </summary>
+    /// <param name="x">The x-coordinate of the center of the ellipse.</param>
+    /// <param name="y">The y-coordinate of the center of the ellipse.</param>
+    /// <param name="rx">The horizontal radius of the ellipse.</param>
+    /// <param name="ry">The vertical radius of the ellipse.</param>
+    void drawEllipse( int x, int y, int rx, int ry ) const;
+
+    void drawEllipse( const glm::ivec2& center, const glm::ivec2& radius ) const
+    {
+        drawEllipse( center.x, center.y, radius.x, radius.y );
+    }
+
     /// <summary>
     /// Draw a triangle using the current rasterizer state.<br>
     /// Required state:
@@ -162,6 +414,37 @@ public:
 
     void drawQuad( Vertex2D v0, Vertex2D v1, Vertex2D v2, Vertex2D v3, const Image& texture, const SamplerState& samplerState = SamplerState {}, std::optional<BlendMode> blendMode = {} ) const;
 
+    /// <summary>
+    /// Draw a batch of textured triangles.<br>
+    /// Each vertex is processed once, no matter how many triangles share it, and the culling and
+    /// clipping of the batch is done in a single draw call. The result is the same as calling drawTriangle for each triangle.
+    /// Required state:
+    /// - cullMode
+    /// - frontCounterClockwise
+    /// - blendMode (if no blend mode is specified)
+    /// - colorTarget
+    /// - viewport
+    /// </summary>
+    /// <param name="vertices">The vertices of the triangles (in screen coordinates).</param>
+    /// <param name="indices">3 vertex indices per triangle. If empty, every 3 consecutive vertices form a triangle.</param>
+    /// <param name="texture">The texture to apply to the triangles.</param>
+    /// <param name="samplerState">The sampler state used to sample the texture.</param>
+    /// <param name="blendMode">(optional) The blend mode to use. If not specified, the blend mode of the rasterizer state is used.</param>
+    void drawTriangles( std::span<const Vertex2D> vertices, std::span<const uint32_t> indices, const Image& texture, const SamplerState& samplerState = SamplerState {}, std::optional<BlendMode> blendMode = {} ) const;
+
+    /// <summary>
+    /// Draw a batch of textured quads.<br>
+    /// Quad i has the vertices v0, v1, v2, v3 and is drawn as the triangles (v0, v1, v2) and (v2, v3, v0).
+    /// The result is the same as calling drawQuad for each quad.
+    /// The vertex buffer of a tile map (TileMap::getVertexBuffer) can be drawn in a single call with empty indices.
+    /// </summary>
+    /// <param name="vertices">The vertices of the quads (in screen coordinates).</param>
+    /// <param name="indices">4 vertex indices per quad. If empty, every 4 consecutive vertices form a quad.</param>
+    /// <param name="texture">The texture to apply to the quads.</param>
+    /// <param name="samplerState">The sampler state used to sample the texture.</param>
+    /// <param name="blendMode">(optional) The blend mode to use. If not specified, the blend mode of the rasterizer state is used.</param>
+    void drawQuads( std::span<const Vertex2D> vertices, std::span<const uint32_t> indices, const Image& texture, const SamplerState& samplerState = SamplerState {}, std::optional<BlendMode> blendMode = {} ) const;
+
     /// <summary>
     /// Draws an axis-aligned bounding box (AABB).
     /// Required state:
@@ -222,7 +505,12 @@ public:
     void drawText( std::string_view text, int x, int y ) const;
 
     /// <summary>
-    /// Draws the specified text at the given coordinates, if provided.
+    /// Draws the specified text at the given coordinates, if provided.<br>
+    /// The rendered image of the text (see Text::getImage) is clipped to the viewport and scissor rect, and alpha blended
+    /// (unless blending is enabled in the blend mode of the rasterizer state, then that blend mode is used instead).<br>
+    /// Required state:
+    /// - blendMode
+    /// - colorTarget
     /// </summary>
     /// <param name="text">The text object to be drawn.</param>
     /// <param name="x">The x-coordinate where the text will be drawn.</param>
@@ -230,7 +518,15 @@ public:
     void drawText( const Text& text, int x, int y ) const;
 
     /// <summary>
-    /// Draws the specified text at the given coordinates using the provided font.
+    /// Draws the specified text at the given coordinates using the provided font.<br>
+    /// The text is drawn as quads from the glyph atlas of the font (see Font::getGlyphAtlas), tinted with the color
+    /// (and the outline color) of the rasterizer state. The quads are alpha blended (unless blending is enabled
+    /// in the blend mode of the rasterizer state, then that blend mode is used instead).<br>
+    /// Required state:
+    /// - blendMode
+    /// - color
+    /// - outlineColor
+    /// - colorTarget
     /// </summary>
     /// <param name="font">The font to use for rendering the text.</param>
     /// <param name="text">The text string to be drawn.</param>
@@ -239,23 +535,83 @@ public:
     void drawText( std::shared_ptr<const Font> font, std::string_view text, int x, int y ) const;
 
 private:
+    struct Binner;
+
     /// <summary>
-    /// Draws a line between two points using an algorithm optimized for lines with a shallow slope (|dy| < |dx|).
+    /// Record a draw call when recording a command list or when binning is enabled.
+    /// Otherwise, prepare the region of the color target that the draw call writes to (see Image::fastClear and Image::markDirty).
     /// </summary>
-    /// <param name="x0">The x-coordinate of the starting point.</param>
-    /// <param name="y0">The y-coordinate of the starting point.</param>
-    /// <param name="x1">The x-coordinate of the ending point.</param>
-    /// <param name="y1">The y-coordinate of the ending point.</param>
-    void drawLineLow( int x0, int y0, int x1, int y1 ) const;
+    /// <param name="bounds">The screen-space bounds of the primitive.</param>
+    /// <param name="command">The draw call to replay.</param>
+    /// <param name="overwritten">(optional) The region where the draw call replaces every pixel (opaque blits and fills).
+    /// The tiles of a lazy clear that are completely inside of this region are not cleared.</param>
+    /// <returns>true if the draw call was consumed, false if it should be executed immediately.</returns>
+    bool bin( const math::AABB& bounds, std::function<void( const Rasterizer& )> command, const std::optional<math::AABB>& overwritten = {} ) const;
 
     /// <summary>
-    /// Draws a line between two points using an algorithm optimized for lines with a steep slope (|dy| > |dx|).
+    /// Sort a draw call into the tiles of the binner.
     /// </summary>
-    /// <param name="x0">The x-coordinate of the starting point.</param>
-    /// <param name="y0">The y-coordinate of the starting point.</param>
-    /// <param name="x1">The x-coordinate of the ending point.</param>
-    /// <param name="y1">The y-coordinate of the ending point.</param>
-    void drawLineHigh( int x0, int y0, int x1, int y1 ) const;
+    /// <param name="commandState">The rasterizer state to use when replaying the draw call.</param>
+    /// <param name="bounds">The screen-space bounds of the primitive.</param>
+    /// <param name="command">The draw call to replay for each tile that is overlapped by the primitive.</param>
+    /// <returns>true if the draw call was consumed by the binner, false if binning is not enabled.</returns>
+    bool submit( const State& commandState, const math::AABB& bounds, std::function<void( const Rasterizer& )> command ) const;
+
+    /// <summary>
+    /// Get the region of the color target that can be written to.
+    /// This is the intersection of the color target, the viewport, and the scissor (when replaying a tile).
+    /// </summary>
+    math::AABB getClipAABB() const;
+
+    /// <summary>
+    /// Get the coverage mask of the rasterizer state for a draw call with the blend mode.<br>
+    /// Returns nullptr if the blend mode is not opaque (BlendMode::Disable or BlendMode::AlphaDiscard),
+    /// or if the coverage mask doesn't match the size of the color target.
+    /// </summary>
+    /// <param name="blendMode">The blend mode of the draw call.</param>
+    CoverageMask* getCoverageMask( const BlendMode& blendMode ) const;
+
+    /// <summary>
+    /// Draw a list of lines, where each line is given as ( x0, y0, x1, y1 ).
+    /// </summary>
+    void drawLineList( std::vector<glm::ivec4> lines ) const;
+
+    /// <summary>
+    /// Draw a batch of primitives, where primitive i covers the pixels bounds[i] ( minX, minY, maxX, maxY ).<br>
+    /// The primitives are culled against the clip rectangle and sorted into screen tiles. While binning, each tile
+    /// is binned as a separate draw call. Otherwise, the tiles are rasterized in parallel.
+    /// draw( rasterizer, indices ) must draw the primitives with the indices (in the given order) clipped to the clip rectangle of the rasterizer.
+    /// </summary>
+    void drawBatch( std::span<const glm::ivec4> bounds, const std::function<void( const Rasterizer&, std::span<const uint32_t> )>& draw ) const;
+
+    /// <summary>
+    /// Draw the outline of an ellipse with the color of the rasterizer state.<br>
+    /// The outline of a row are the pixels of the row that are not covered by the next row (away from the center).
+    /// </summary>
+    void outlineEllipse( int cx, int cy, int rx, int ry ) const;
+
+    /// <summary>
+    /// Fill an ellipse with the color of the rasterizer state, one span per row.
+    /// </summary>
+    void fillEllipse( int cx, int cy, int rx, int ry ) const;
+
+    /// <summary>
+    /// Draw an axis-aligned, scaled (and possibly flipped) region of an image.
+    /// This produces the same pixels as drawing the region as a textured quad, but the source
+    /// texels are stepped with an integer DDA and the rows are blended as spans.
+    /// </summary>
+    /// <param name="image">The source image.</param>
+    /// <param name="p0">The screen position of the texture coordinate t0.</param>
+    /// <param name="p1">The screen position of the texture coordinate t1 (the opposite corner of the region).</param>
+    /// <param name="t0">The texture coordinate of the first corner of the region.</param>
+    /// <param name="t1">The texture coordinate of the opposite corner of the region.</param>
+    /// <param name="color">The color to multiply the source texels with.</param>
+    /// <param name="blendMode">The blend mode to apply.</param>
+    void drawScaled( const Image& image, const glm::vec2& p0, const glm::vec2& p1, const glm::ivec2& t0, const glm::ivec2& t1, const Color& color, const BlendMode& blendMode ) const;
+
+    std::shared_ptr<Binner>   m_Binner;                 ///< Binned draw calls (only valid while binning, shared with copies).
+    std::optional<math::AABB> m_Scissor;                ///< The tile that is being rasterized (only valid when replaying a tile).
+    CommandList*              m_CommandList = nullptr;  ///< The command list that is being recorded to (only valid while recording).
 };
 
 }  // namespace graphics
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <coroutine>
+#include <exception>  // For std::terminate
 #include <utility>
 
 namespace sr
@@ -10,6 +11,7 @@ inline namespace graphics
 
 /// A simple coroutine type that suspends at each co_yield, allowing
 /// work to be spread across multiple frames.
+/// Schedule a task with the TaskScheduler to resume it in the idle time of each frame.
 class Task
 {
 public:
@@ -32,29 +34,15 @@ public:
     : m_Handle { h }
     {}
 
-    ~Task()
-    {
-        if ( m_Handle )
-            m_Handle.destroy();
-    }
+    /// Destroys the coroutine, and removes the task from the TaskScheduler.
+    ~Task();
 
     Task( const Task& )            = delete;
     Task& operator=( const Task& ) = delete;
 
-    Task( Task&& other ) noexcept
-    : m_Handle { std::exchange( other.m_Handle, nullptr ) }
-    {}
-
-    Task& operator=( Task&& other ) noexcept
-    {
-        if ( this != &other )
-        {
-            if ( m_Handle )
-                m_Handle.destroy();
-            m_Handle = std::exchange( other.m_Handle, nullptr );
-        }
-        return *this;
-    }
+    /// A scheduled task stays scheduled when it is moved.
+    Task( Task&& other ) noexcept;
+    Task& operator=( Task&& other ) noexcept;
 
     /// Returns true if the coroutine has not yet finished.
     explicit operator bool() const { return m_Handle && !m_Handle.done(); }
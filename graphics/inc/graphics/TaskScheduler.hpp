@@ -0,0 +1,102 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+
+namespace sr
+{
+inline namespace graphics
+{
+class Task;
+
+/// <summary>
+/// A global cooperative scheduler for Task coroutines.<br>
+/// Scheduled tasks are resumed in turn (round-robin) until the time budget of the frame is used up,
+/// so background work (for example, rendering the cached image of a Text) uses the idle time of a frame
+/// instead of advancing a fixed amount per frame.<br>
+/// Window::present updates the scheduler with the frame budget (see setBudget). Call update to resume tasks explicitly.<br>
+/// Tasks are only resumed between co_yield statements, so a single step of a task can still exceed the budget.
+/// Tasks must be scheduled, resumed, and destroyed on the same thread.
+/// </summary>
+namespace TaskScheduler
+{
+
+/// <summary>
+/// The default time budget per frame.
+/// </summary>
+inline constexpr std::chrono::microseconds DefaultBudget { 2000 };
+
+/// <summary>
+/// The statistics of an update of the scheduler.
+/// </summary>
+struct Statistics
+{
+    std::size_t               queueDepth = 0;  ///< The number of tasks that are still scheduled after the update.
+    std::size_t               resumed    = 0;  ///< The number of times a task was resumed.
+    std::size_t               completed  = 0;  ///< The number of tasks that finished.
+    std::chrono::microseconds timeSpent { 0 };  ///< The time spent resuming tasks.
+};
+
+/// <summary>
+/// Schedule a task. The task is resumed by update until it is finished, canceled, or destroyed.<br>
+/// The task object must stay alive while it is scheduled (moving it keeps it scheduled).
+/// </summary>
+/// <param name="task">The task to schedule. Finished tasks and tasks that are already scheduled are ignored.</param>
+void schedule( Task& task );
+
+/// <summary>
+/// Remove a task from the scheduler (without resuming or destroying the coroutine).
+/// </summary>
+/// <param name="task">The task to remove.</param>
+void cancel( const Task& task ) noexcept;
+
+/// <summary>
+/// Check if a task is scheduled.
+/// </summary>
+/// <param name="task">The task to check.</param>
+/// <returns>true if the task is scheduled.</returns>
+bool isScheduled( const Task& task ) noexcept;
+
+/// <summary>
+/// Resume the scheduled tasks until all tasks are finished, or the time budget is used up.
+/// </summary>
+/// <param name="budget">The time budget. No tasks are resumed if the budget is 0.</param>
+/// <returns>The statistics of the update.</returns>
+const Statistics& update( std::chrono::microseconds budget );
+
+/// <summary>
+/// Resume the scheduled tasks until all tasks are finished, or the time budget of the frame is used up.
+/// </summary>
+/// <returns>The statistics of the update.</returns>
+const Statistics& update();
+
+/// <summary>
+/// Set the time budget per frame. Set the budget to 0 to pause the tasks (unless update is called explicitly with a budget).
+/// </summary>
+/// <param name="budget">The time budget per frame. Default: DefaultBudget.</param>
+void setBudget( std::chrono::microseconds budget ) noexcept;
+
+/// <summary>
+/// Get the time budget per frame.
+/// </summary>
+/// <returns>The time budget per frame.</returns>
+std::chrono::microseconds getBudget() noexcept;
+
+/// <summary>
+/// Get the number of scheduled tasks.
+/// </summary>
+/// <returns>The number of tasks that are waiting to be resumed.</returns>
+std::size_t getQueueDepth() noexcept;
+
+/// <summary>
+/// Get the statistics of the last update.
+/// </summary>
+/// <returns>The statistics of the last update.</returns>
+const Statistics& getStatistics() noexcept;
+
+// For internal use: a scheduled task was moved.
+void replace( const Task& from, Task& to ) noexcept;
+
+}  // namespace TaskScheduler
+}  // namespace graphics
+}  // namespace sr
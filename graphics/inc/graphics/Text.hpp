@@ -277,7 +277,23 @@ public:
     Text& setWrapWidth( int width );
 
     /// <summary>
-    /// Draws the Text at the specified position on the image.
+    /// Get the rendered image of the text (including the outline, drop shadow, and glow).<br>
+    /// When the text changes, the image is re-rendered in the background (see TaskScheduler), and the previous image is returned until the new one is finished.
+    /// Draw calls that still use the previous image keep it alive.
+    /// </summary>
+    /// <returns>The rendered image of the text, or nullptr if the text has not been rendered yet.</returns>
+    std::shared_ptr<const Image> getImage() const;
+
+    /// <summary>
+    /// Get the padding (in pixels) around the text in the rendered image.
+    /// The top-left corner of the text is at (padding, padding) in the image returned by getImage.
+    /// </summary>
+    /// <returns>The padding around the text in the rendered image.</returns>
+    int getImagePadding() const;
+
+    /// <summary>
+    /// Draws the Text at the specified position on the image (alpha blended).<br>
+    /// Use Rasterizer::drawText to draw the text with the viewport, scissor rect, and blend mode of the rasterizer state.
     /// </summary>
     /// <param name="image">The image to draw on.</param>
     /// <param name="x">The x-coordinate of the position.</param>
@@ -317,14 +333,14 @@ private:
     // Set to true when the text content or properties have changed and the text needs to be re-rendered.
     mutable bool   m_IsDirty  = true;
     mutable size_t m_FontHash = 0;
-    // Cached surface for the text. This is used to optimize rendering by avoiding redundant text rendering operations when the text content or properties haven't changed.
-    mutable SurfacePtr m_CachedSurface;
-    mutable int        m_CachedPadding = 0;
+    // Cached image of the text. This is used to optimize rendering by avoiding redundant text rendering operations when the text content or properties haven't changed.
+    mutable std::shared_ptr<const Image> m_CachedImage;
+    mutable int                          m_CachedPadding = 0;
 
-    // Coroutine that updates m_CachedSurface over several frames.
+    // Coroutine that updates m_CachedImage over several frames (resumed by the TaskScheduler).
     mutable Task m_UpdateTask;
 
-    Task updateCachedSurface() const;
+    Task updateCachedImage() const;
 
     static void       setColor( const TextPtr& t, const Color& c );
     static Color      getColor( const TextPtr& t );
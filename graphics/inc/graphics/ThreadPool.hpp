@@ -0,0 +1,231 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <concepts>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <ranges>
+#include <thread>
+#include <vector>
+
+namespace sr
+{
+inline namespace graphics
+{
+/// <summary>
+/// A work-stealing thread pool.<br>
+/// Each worker thread has its own queue of jobs. A worker runs the jobs of its own queue in LIFO order (the most recent job is still in the cache),
+/// and steals the oldest jobs from the queues of the other workers when its own queue is empty.
+/// Jobs that are submitted by other threads (for example, the main thread) are added to a shared queue that the workers steal from.<br>
+/// Threads that wait for jobs (see TaskGroup::wait) run pending jobs while they wait, so parallel loops can be nested.<br>
+/// The rasterizer uses the global thread pool (see ThreadPool::get) for all parallel work.
+/// Jobs must not throw exceptions (std::terminate is called, like the parallel algorithms of the standard library).
+/// </summary>
+class ThreadPool final
+{
+public:
+    using Job = std::function<void()>;
+
+    /// <summary>
+    /// Create a thread pool.
+    /// </summary>
+    /// <param name="threadCount">The number of threads that run jobs, including the thread that waits for them.
+    /// The pool starts threadCount - 1 worker threads. Use 1 to run all jobs on the waiting thread.</param>
+    explicit ThreadPool( unsigned threadCount = getDefaultThreadCount() );
+
+    /// <summary>
+    /// Run the remaining jobs, and stop the worker threads.
+    /// </summary>
+    ~ThreadPool();
+
+    ThreadPool( const ThreadPool& )            = delete;
+    ThreadPool( ThreadPool&& )                 = delete;
+    ThreadPool& operator=( const ThreadPool& ) = delete;
+    ThreadPool& operator=( ThreadPool&& )      = delete;
+
+    /// <summary>
+    /// Get the global thread pool. It is created the first time it is used.
+    /// </summary>
+    /// <returns>The global thread pool.</returns>
+    static ThreadPool& get();
+
+    /// <summary>
+    /// Set the number of threads of the global thread pool. The global thread pool is recreated.<br>
+    /// This must not be called while jobs are running, or task groups of the global thread pool are alive.
+    /// </summary>
+    /// <param name="threadCount">The number of threads that run jobs (see ThreadPool::ThreadPool).</param>
+    static void setThreadCount( unsigned threadCount );
+
+    /// <summary>
+    /// Get the default number of threads.
+    /// This is the value of the SR_NUM_THREADS environment variable (if it is set), or the number of hardware threads.
+    /// </summary>
+    /// <returns>The default number of threads.</returns>
+    static unsigned getDefaultThreadCount();
+
+    /// <summary>
+    /// Get the number of threads that run jobs (the worker threads and the waiting thread).
+    /// </summary>
+    unsigned getThreadCount() const noexcept
+    {
+        return static_cast<unsigned>( m_Threads.size() ) + 1;
+    }
+
+    /// <summary>
+    /// Submit a job. Use a TaskGroup to wait for jobs.
+    /// </summary>
+    /// <param name="job">The job to run.</param>
+    void submit( Job job );
+
+    /// <summary>
+    /// Run a pending job on the calling thread (if there is one).
+    /// </summary>
+    /// <returns>true if a job was run.</returns>
+    bool runPendingJob();
+
+private:
+    struct Queue
+    {
+        std::mutex      mutex;
+        std::deque<Job> jobs;
+    };
+
+    /// <summary>
+    /// The loop of a worker thread.
+    /// </summary>
+    void run( size_t index );
+
+    /// <summary>
+    /// Get the index of the queue of the calling thread (the shared queue if the calling thread is not a worker thread of this pool).
+    /// </summary>
+    size_t getQueueIndex() const noexcept;
+
+    /// <summary>
+    /// Take a job from the queue of a thread, or steal a job from another queue.
+    /// </summary>
+    bool takeJob( size_t index, Job& job );
+
+    // One queue per worker thread, and the shared queue (the last queue) for the other threads.
+    std::vector<std::unique_ptr<Queue>> m_Queues;
+    std::vector<std::thread>            m_Threads;
+
+    std::atomic<size_t>     m_Pending = 0;  ///< The number of jobs in the queues.
+    std::mutex              m_Mutex;        ///< Protects m_Stop, and prevents lost wake-ups of sleeping workers.
+    std::condition_variable m_Condition;    ///< Wakes up sleeping workers.
+    bool                    m_Stop = false;
+};
+
+/// <summary>
+/// A group of jobs that can be waited for.<br>
+/// Continuations (see TaskGroup::then) run after all jobs of the group have finished, without blocking a thread.
+/// The destructor waits for all jobs (and continuations) of the group.
+/// </summary>
+class TaskGroup final
+{
+public:
+    explicit TaskGroup( ThreadPool& pool = ThreadPool::get() );
+    ~TaskGroup();
+
+    TaskGroup( const TaskGroup& )            = delete;
+    TaskGroup& operator=( const TaskGroup& ) = delete;
+
+    /// <summary>
+    /// Run a job in the thread pool as part of this group.
+    /// </summary>
+    /// <param name="job">The job to run.</param>
+    void run( ThreadPool::Job job );
+
+    /// <summary>
+    /// Add a continuation that runs (in the thread pool) when all jobs of the group have finished.
+    /// Continuations are part of the group, so they can run more jobs, and wait waits for them too.
+    /// If the group is idle, the continuation runs right away.
+    /// </summary>
+    /// <param name="continuation">The job to run when the jobs of the group have finished.</param>
+    void then( ThreadPool::Job continuation );
+
+    /// <summary>
+    /// Wait for all jobs and continuations of the group to finish. The calling thread runs pending jobs while it waits.
+    /// </summary>
+    void wait();
+
+    /// <summary>
+    /// Check if all jobs and continuations of the group have finished.
+    /// </summary>
+    bool isIdle() const;
+
+private:
+    /// <summary>
+    /// Called when a job of the group has finished.
+    /// </summary>
+    void finish();
+
+    ThreadPool& m_Pool;
+
+    mutable std::mutex           m_Mutex;
+    std::condition_variable      m_Condition;
+    size_t                       m_Count = 0;      ///< The number of jobs of the group that have not finished.
+    std::vector<ThreadPool::Job> m_Continuations;  ///< The continuations that run when m_Count reaches 0.
+};
+
+/// <summary>
+/// Call a function for each index in [first, last) in parallel.<br>
+/// The range is split into chunks of grainSize indices. The calling thread runs the first chunk and helps with the others until all chunks are done.
+/// </summary>
+/// <param name="first">The first index.</param>
+/// <param name="last">One past the last index.</param>
+/// <param name="function">The function to call for each index.</param>
+/// <param name="grainSize">The number of indices per job. If 0, the range is split into about 4 jobs per thread.</param>
+/// <param name="pool">The thread pool that runs the jobs. Default: the global thread pool.</param>
+template<std::integral Index, typename Function>
+void parallelFor( Index first, Index last, Function&& function, Index grainSize = 0, ThreadPool& pool = ThreadPool::get() )
+{
+    if ( first >= last )
+        return;
+
+    const auto count = static_cast<size_t>( last - first );
+    const auto grain = grainSize > 0 ? static_cast<size_t>( grainSize ) : std::max<size_t>( 1, count / ( pool.getThreadCount() * 4 ) );
+
+    auto runChunk = [&function, first, last]( size_t begin, size_t end ) {
+        for ( Index i = first + static_cast<Index>( begin ); i < first + static_cast<Index>( end ) && i < last; ++i )
+            function( i );
+    };
+
+    if ( count <= grain || pool.getThreadCount() == 1 )
+    {
+        runChunk( 0, count );
+        return;
+    }
+
+    TaskGroup group( pool );
+
+    for ( size_t begin = grain; begin < count; begin += grain )
+        group.run( [&runChunk, begin, grain] { runChunk( begin, begin + grain ); } );
+
+    runChunk( 0, grain );
+
+    group.wait();
+}
+
+/// <summary>
+/// Call a function for each element of a random access range in parallel (see parallelFor).
+/// </summary>
+/// <param name="range">The range of elements.</param>
+/// <param name="function">The function to call for each element.</param>
+/// <param name="grainSize">The number of elements per job. If 0, the range is split into about 4 jobs per thread.</param>
+/// <param name="pool">The thread pool that runs the jobs. Default: the global thread pool.</param>
+template<std::ranges::random_access_range Range, typename Function>
+void parallelForEach( Range&& range, Function&& function, size_t grainSize = 0, ThreadPool& pool = ThreadPool::get() )
+{
+    auto begin = std::ranges::begin( range );
+
+    parallelFor( size_t { 0 }, static_cast<size_t>( std::ranges::distance( range ) ), [&function, &begin]( size_t i ) { function( begin[static_cast<std::ranges::range_difference_t<Range>>( i )] ); }, grainSize, pool );
+}
+
+}  // namespace graphics
+}  // namespace sr
@@ -83,13 +83,47 @@ public:
 
     void present( const Image& image );
 
+    /// <summary>
+    /// Acquire an image that renders directly into a streaming texture of the window, so present doesn't need to copy the image to the texture.
+    /// The window uses two streaming textures in turn, so the texture of the previous frame can still be drawn while the next frame is rendered.
+    /// The contents of the image are undefined after it is acquired, so the entire frame must be drawn (for example, starting with a clear).
+    /// Pass the image to present( const Image& ) to unlock the texture and present it.<br>
+    /// The locked pixels of a streaming texture can be write-combined (or mapped GPU) memory that is very slow to read.
+    /// Blending (and any other draw call that reads the color target) reads these pixels, so frames that mostly blend
+    /// should be rendered to an Image and passed to present( const Image& ) instead, which uploads only its dirty regions.
+    /// </summary>
+    /// <param name="width">The width of the frame (in pixels).</param>
+    /// <param name="height">The height of the frame (in pixels).</param>
+    /// <returns>The image of the frame, or nullptr if the texture could not be locked.</returns>
+    Image* acquireFrame( int width, int height );
+
 private:
     void beginFrame();
 
+    /// <summary>
+    /// Unlock the texture of the acquired frame and present it.
+    /// </summary>
+    void presentFrame();
+
+    /// <summary>
+    /// Draw a texture centered in the window (maintaining the aspect ratio) and present the window.
+    /// </summary>
+    void presentTexture( SDL_Texture* texture, int width, int height );
+
     SDL_Window*   m_Window   = nullptr;
     SDL_Renderer* m_Renderer = nullptr;
     SDL_Texture*  m_Texture  = nullptr;
 
+    /// The image that was last uploaded to the texture. Only the dirty regions are uploaded when the same image is presented again.
+    const Image* m_PresentedImage = nullptr;
+
+    /// The streaming textures that the acquired frames are rendered to (see acquireFrame).
+    SDL_Texture* m_FrameTextures[2] = {};
+    int          m_FrameIndex       = 0;        ///< The texture of the current frame.
+    void*        m_FramePixels      = nullptr;  ///< The locked pixels of the texture of the current frame (null if the frame is not acquired).
+    int          m_FramePitch       = 0;        ///< The pitch (in bytes) of the locked pixels.
+    Image        m_Frame;                       ///< The image of the current frame (a view over the locked pixels if the rows are not padded).
+
     int  m_Width      = -1;
     int  m_Height     = -1;
     bool m_Fullscreen = false;
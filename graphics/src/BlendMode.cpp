@@ -1,6 +1,7 @@
 #include <graphics/BlendMode.hpp>
 
 using namespace sr::graphics;
+using namespace sr::math;
 
 const BlendMode BlendMode::Disable { false };
 const BlendMode BlendMode::AlphaDiscard { true, 127 };
@@ -8,3 +9,276 @@ const BlendMode BlendMode::AlphaBlend { true, 0, BlendFactor::SrcAlpha, BlendFac
 const BlendMode BlendMode::AdditiveBlend { true, 0, BlendFactor::One, BlendFactor::One };
 const BlendMode BlendMode::SubtractiveBlend { true, 0, BlendFactor::One, BlendFactor::One, BlendOperation::Subtract };
 const BlendMode BlendMode::MultiplicativeBlend { true, 0, BlendFactor::Zero, BlendFactor::SrcColor };
+
+
+namespace
+{
+#if defined( SR_SIMD_SSE2 )
+// 4 pixels per 128-bit register.
+using simd_color = __m128i;
+
+simd_color simd_load( const Color* p ) noexcept
+{
+    return _mm_loadu_si128( reinterpret_cast<const __m128i*>( p ) );
+}
+
+void simd_store( Color* p, simd_color v ) noexcept
+{
+    _mm_storeu_si128( reinterpret_cast<__m128i*>( p ), v );
+}
+
+simd_color simd_set1( const Color& c ) noexcept
+{
+    return _mm_set1_epi32( static_cast<int>( c.rgba ) );
+}
+
+simd_color simd_zero() noexcept
+{
+    return _mm_setzero_si128();
+}
+
+simd_color simd_add_u8( simd_color a, simd_color b ) noexcept
+{
+    return _mm_add_epi8( a, b );
+}
+
+simd_color simd_sub_u8( simd_color a, simd_color b ) noexcept
+{
+    return _mm_sub_epi8( a, b );
+}
+
+// Broadcast the alpha channel of each pixel to all 4 channels.
+simd_color simd_broadcast_alpha( simd_color v ) noexcept
+{
+    simd_color a = _mm_srli_epi32( v, 24 );
+    a            = _mm_or_si128( a, _mm_slli_epi32( a, 8 ) );
+    return _mm_or_si128( a, _mm_slli_epi32( a, 16 ) );
+}
+
+// A mask of the pixels whose alpha channel is less than the threshold.
+simd_color simd_alpha_less( simd_color v, uint8_t threshold ) noexcept
+{
+    return _mm_cmplt_epi32( _mm_srli_epi32( v, 24 ), _mm_set1_epi32( threshold ) );
+}
+
+// Select a where the mask is set, otherwise b.
+simd_color simd_select( simd_color mask, simd_color a, simd_color b ) noexcept
+{
+    return _mm_or_si128( _mm_and_si128( mask, a ), _mm_andnot_si128( mask, b ) );
+}
+#elif defined( SR_SIMD_NEON )
+// 4 pixels per 128-bit register.
+using simd_color = uint8x16_t;
+
+simd_color simd_load( const Color* p ) noexcept
+{
+    return vld1q_u8( reinterpret_cast<const uint8_t*>( p ) );
+}
+
+void simd_store( Color* p, simd_color v ) noexcept
+{
+    vst1q_u8( reinterpret_cast<uint8_t*>( p ), v );
+}
+
+simd_color simd_set1( const Color& c ) noexcept
+{
+    return vreinterpretq_u8_u32( vdupq_n_u32( c.rgba ) );
+}
+
+simd_color simd_zero() noexcept
+{
+    return vdupq_n_u8( 0 );
+}
+
+simd_color simd_add_u8( simd_color a, simd_color b ) noexcept
+{
+    return vaddq_u8( a, b );
+}
+
+simd_color simd_sub_u8( simd_color a, simd_color b ) noexcept
+{
+    return vsubq_u8( a, b );
+}
+
+// Broadcast the alpha channel of each pixel to all 4 channels.
+simd_color simd_broadcast_alpha( simd_color v ) noexcept
+{
+    const uint32x4_t a = vshrq_n_u32( vreinterpretq_u32_u8( v ), 24 );
+    return vreinterpretq_u8_u32( vmulq_n_u32( a, 0x01010101u ) );
+}
+
+// A mask of the pixels whose alpha channel is less than the threshold.
+simd_color simd_alpha_less( simd_color v, uint8_t threshold ) noexcept
+{
+    return vreinterpretq_u8_u32( vcltq_u32( vshrq_n_u32( vreinterpretq_u32_u8( v ), 24 ), vdupq_n_u32( threshold ) ) );
+}
+
+// Select a where the mask is set, otherwise b.
+simd_color simd_select( simd_color mask, simd_color a, simd_color b ) noexcept
+{
+    return vbslq_u8( mask, a, b );
+}
+#endif
+
+#if defined( SR_SIMD_SSE2 ) || defined( SR_SIMD_NEON )
+constexpr size_t SimdWidth = sizeof( simd_color ) / sizeof( Color );
+
+// Vectorized ComputeBlendFactor.
+// The alpha channel of the color blend factor is the same as the alpha blend factor,
+// so the same function is used for the color and alpha blend factors.
+simd_color simd_blend_factor( simd_color src, simd_color dst, simd_color srcAlpha, simd_color dstAlpha, BlendFactor blendFactor ) noexcept
+{
+    const simd_color one = simd_set1( Color::White );
+
+    switch ( blendFactor )
+    {
+    case BlendFactor::Zero:
+        return simd_zero();
+    case BlendFactor::One:
+        return one;
+    case BlendFactor::SrcColor:
+        return src;
+    case BlendFactor::OneMinusSrcColor:
+        return simd_sub_saturated_u8( one, src );
+    case BlendFactor::DstColor:
+        return dst;
+    case BlendFactor::OneMinusDstColor:
+        return simd_sub_saturated_u8( one, dst );
+    case BlendFactor::SrcAlpha:
+        return srcAlpha;
+    case BlendFactor::OneMinusSrcAlpha:
+        return simd_sub_saturated_u8( one, srcAlpha );
+    case BlendFactor::DstAlpha:
+        return dstAlpha;
+    case BlendFactor::OneMinusDstAlpha:
+        return simd_sub_saturated_u8( one, dstAlpha );
+    case BlendFactor::SrcAlphaSat:
+        return simd_min_u8( srcAlpha, simd_sub_saturated_u8( one, dstAlpha ) );
+    }
+
+    return src;
+}
+
+// Vectorized ComputeBlendOp.
+// The color channels saturate (like the Color operators), the alpha channel wraps (like uint8_t arithmetic).
+simd_color simd_blend_op( simd_color src, simd_color dst, BlendOperation op, bool saturate ) noexcept
+{
+    switch ( op )
+    {
+    case BlendOperation::Add:
+        return saturate ? simd_add_saturated_u8( src, dst ) : simd_add_u8( src, dst );
+    case BlendOperation::Subtract:
+        return saturate ? simd_sub_saturated_u8( src, dst ) : simd_sub_u8( src, dst );
+    case BlendOperation::ReverseSubtract:
+        return saturate ? simd_sub_saturated_u8( dst, src ) : simd_sub_u8( dst, src );
+    case BlendOperation::Min:
+        return simd_min_u8( src, dst );
+    case BlendOperation::Max:
+        return simd_max_u8( src, dst );
+    }
+
+    return src;
+}
+
+// Vectorized BlendMode::Blend (blending must be enabled).
+simd_color simd_blend( const BlendMode& blendMode, simd_color src, simd_color dst ) noexcept
+{
+    const simd_color alphaMask = simd_set1( Color { 0, 0, 0, 255 } );
+    const simd_color srcAlpha  = simd_broadcast_alpha( src );
+    const simd_color dstAlpha  = simd_broadcast_alpha( dst );
+
+    const simd_color srcFactor = simd_select( alphaMask, simd_blend_factor( src, dst, srcAlpha, dstAlpha, blendMode.srcAlphaFactor ), simd_blend_factor( src, dst, srcAlpha, dstAlpha, blendMode.srcFactor ) );
+    const simd_color dstFactor = simd_select( alphaMask, simd_blend_factor( src, dst, srcAlpha, dstAlpha, blendMode.dstAlphaFactor ), simd_blend_factor( src, dst, srcAlpha, dstAlpha, blendMode.dstFactor ) );
+
+    const simd_color s = simd_multiply_u8( srcFactor, src );
+    const simd_color d = simd_multiply_u8( dstFactor, dst );
+
+    const simd_color RGBA = simd_select( alphaMask, simd_blend_op( s, d, blendMode.alphaOp, false ), simd_blend_op( s, d, blendMode.blendOp, true ) );
+
+    // Discard source pixels that are below the alpha threshold.
+    return simd_select( simd_alpha_less( src, blendMode.alphaThreshold ), dst, RGBA );
+}
+#endif
+}  // namespace
+
+void BlendMode::blendSpan( const Color* src, Color* dst, size_t n, const Color& tint ) const noexcept
+{
+    const bool modulate = tint != Color::White;
+
+    if ( !blendEnable && !modulate )
+    {
+        std::copy_n( src, n, dst );
+        return;
+    }
+
+    size_t i = 0;
+
+#if defined( SR_SIMD_SSE2 ) || defined( SR_SIMD_NEON )
+    const simd_color t = simd_set1( tint );
+
+    for ( ; i + SimdWidth <= n; i += SimdWidth )
+    {
+        simd_color s = simd_load( src + i );
+
+        if ( modulate )
+            s = simd_multiply_u8( s, t );
+
+        simd_store( dst + i, blendEnable ? simd_blend( *this, s, simd_load( dst + i ) ) : s );
+    }
+#endif
+
+    for ( ; i < n; ++i )
+    {
+        dst[i] = Blend( modulate ? src[i] * tint : src[i], dst[i] );
+    }
+}
+
+void BlendMode::blendSpan( const Color& src, Color* dst, size_t n ) const noexcept
+{
+    if ( !blendEnable )
+    {
+#if defined( SR_SIMD_SSE2 )
+        // Spans that are larger than this (in pixels) are filled with streaming stores.
+        constexpr size_t StreamThreshold = 1024;
+
+        if ( n >= StreamThreshold )
+        {
+            // Align the destination to 16 bytes.
+            size_t i = 0;
+            for ( ; i < n && reinterpret_cast<uintptr_t>( dst + i ) % sizeof( simd_color ) != 0; ++i )
+                dst[i] = src;
+
+            const simd_color s = simd_set1( src );
+            for ( ; i + SimdWidth <= n; i += SimdWidth )
+                _mm_stream_si128( reinterpret_cast<__m128i*>( dst + i ), s );
+
+            _mm_sfence();
+
+            std::fill_n( dst + i, n - i, src );
+            return;
+        }
+#endif
+        std::fill_n( dst, n, src );
+        return;
+    }
+
+    // The source color is discarded for all pixels.
+    if ( src.channels.a < alphaThreshold )
+        return;
+
+    size_t i = 0;
+
+#if defined( SR_SIMD_SSE2 ) || defined( SR_SIMD_NEON )
+    const simd_color s = simd_set1( src );
+
+    for ( ; i + SimdWidth <= n; i += SimdWidth )
+    {
+        simd_store( dst + i, simd_blend( *this, s, simd_load( dst + i ) ) );
+    }
+#endif
+
+    for ( ; i < n; ++i )
+    {
+        dst[i] = Blend( src, dst[i] );
+    }
+}
\ No newline at end of file
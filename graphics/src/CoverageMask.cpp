@@ -0,0 +1,45 @@
+#include <graphics/CoverageMask.hpp>
+
+using namespace sr::graphics;
+
+CoverageMask::CoverageMask( uint32_t width, uint32_t height )
+{
+    resize( width, height );
+}
+
+void CoverageMask::resize( uint32_t width, uint32_t height )
+{
+    m_Width  = width;
+    m_Height = height;
+    m_Stride = ( width + 63 ) / 64;
+    m_Bits   = std::make_unique<std::atomic<uint64_t>[]>( static_cast<size_t>( m_Stride ) * height );
+
+    clear();
+}
+
+void CoverageMask::clear() noexcept
+{
+    const size_t size = static_cast<size_t>( m_Stride ) * m_Height;
+
+    for ( size_t i = 0; i < size; ++i )
+        m_Bits[i].store( 0, std::memory_order_relaxed );
+}
+
+void CoverageMask::cover( int y, int x0, int x1 ) noexcept
+{
+    assert( x0 >= 0 && x1 < static_cast<int>( m_Width ) && y >= 0 && y < static_cast<int>( m_Height ) );
+
+    const size_t row = static_cast<size_t>( y ) * m_Stride;
+
+    for ( int x = x0; x <= x1; x = ( x & ~63 ) + 64 )
+    {
+        // The bits of the pixels [x, min( x1, end of the word )].
+        const int last = std::min( x1, x | 63 );
+        uint64_t  bits = ~uint64_t { 0 } << ( x & 63 );
+        if ( ( last & 63 ) != 63 )
+            bits &= ( uint64_t { 1 } << ( ( last & 63 ) + 1 ) ) - 1;
+
+        // Neighboring tiles may share a word, so the bits are set atomically.
+        m_Bits[row + ( x >> 6 )].fetch_or( bits, std::memory_order_relaxed );
+    }
+}
@@ -1,4 +1,5 @@
 #include <graphics/Font.hpp>
+#include <graphics/GlyphAtlas.hpp>
 
 #include <SDL_ttf_context.hpp>
 #include <hash.hpp>
@@ -210,8 +211,10 @@ Font::Font( const Font& other )
 
 Font::Font( Font&& other ) noexcept
 {
-    m_FillFont    = std::exchange( other.m_FillFont, nullptr );
-    m_OutlineFont = std::exchange( other.m_OutlineFont, nullptr );
+    m_FillFont       = std::exchange( other.m_FillFont, nullptr );
+    m_OutlineFont    = std::exchange( other.m_OutlineFont, nullptr );
+    m_GlyphAtlas     = std::exchange( other.m_GlyphAtlas, nullptr );
+    m_GlyphAtlasHash = std::exchange( other.m_GlyphAtlasHash, 0 );
 }
 
 Font& Font::operator=( const Font& other )
@@ -221,6 +224,7 @@ Font& Font::operator=( const Font& other )
 
     m_FillFont.reset( TTF_CopyFont( other.m_FillFont.get() ) );
     m_OutlineFont.reset( TTF_CopyFont( other.m_OutlineFont.get() ) );
+    m_GlyphAtlas.reset();
 
     m_FallbackFonts = other.m_FallbackFonts;
 
@@ -232,8 +236,10 @@ Font& Font::operator=( Font&& other ) noexcept
     if ( &other == this )
         return *this;
 
-    m_FillFont    = std::exchange( other.m_FillFont, nullptr );
-    m_OutlineFont = std::exchange( other.m_OutlineFont, nullptr );
+    m_FillFont       = std::exchange( other.m_FillFont, nullptr );
+    m_OutlineFont    = std::exchange( other.m_OutlineFont, nullptr );
+    m_GlyphAtlas     = std::exchange( other.m_GlyphAtlas, nullptr );
+    m_GlyphAtlasHash = std::exchange( other.m_GlyphAtlasHash, 0 );
 
     return *this;
 }
@@ -581,6 +587,19 @@ Font& Font::clearFallbackFonts()
     return *this;
 }
 
+std::shared_ptr<GlyphAtlas> Font::getGlyphAtlas() const
+{
+    // The rendered glyphs are no longer valid if the font changed.
+    const std::size_t hash = std::hash<Font> {}( *this );
+    if ( !m_GlyphAtlas || m_GlyphAtlasHash != hash )
+    {
+        m_GlyphAtlas     = std::make_shared<GlyphAtlas>( m_FillFont.get(), m_OutlineFont.get() );
+        m_GlyphAtlasHash = hash;
+    }
+
+    return m_GlyphAtlas;
+}
+
 Font::Font( TTF_Font* fillFont, TTF_Font* outlineFont )
 : m_FillFont { fillFont }
 , m_OutlineFont { outlineFont }
@@ -0,0 +1,126 @@
+#include <graphics/FramePipeline.hpp>
+#include <graphics/Window.hpp>
+
+#include <algorithm>
+#include <cassert>
+
+using namespace sr::graphics;
+
+FramePipeline::FramePipeline( uint32_t width, uint32_t height, int frameCount )
+: m_Frames( static_cast<size_t>( std::clamp( frameCount, 2, 3 ) ) )
+{
+    // With a single frame buffer, submit waits for the previous frame to be presented, but the previous frame
+    // is presented after the next one is submitted, so at least two frame buffers are required (the frame count is clamped).
+
+    for ( Frame& frame: m_Frames )
+        frame.image.resize( width, height );
+
+    m_Thread = std::thread( &FramePipeline::run, this );
+}
+
+FramePipeline::~FramePipeline()
+{
+    {
+        std::lock_guard lock( m_Mutex );
+        m_Stop = true;
+    }
+    m_Condition.notify_all();
+
+    m_Thread.join();
+}
+
+uint64_t FramePipeline::submit( Rasterizer::CommandList commandList )
+{
+    std::unique_lock lock( m_Mutex );
+
+    // Wait for the frame buffer of the new frame to be presented.
+    m_Condition.wait( lock, [this] { return m_Submitted - m_Presented < m_Frames.size(); } );
+
+    const uint64_t fence = ++m_Submitted;
+    m_Frames[( fence - 1 ) % m_Frames.size()].commands = std::move( commandList );
+
+    lock.unlock();
+    m_Condition.notify_all();
+
+    return fence;
+}
+
+void FramePipeline::present( Window& window, uint64_t fence )
+{
+    {
+        std::unique_lock lock( m_Mutex );
+
+        assert( fence <= m_Submitted );
+
+        if ( fence <= m_Presented )
+            return;
+
+        m_Condition.wait( lock, [this, fence] { return m_Completed >= fence; } );
+    }
+
+    // The render thread doesn't touch the frame buffer until it is released.
+    window.present( getFrame( fence ) );
+
+    {
+        std::lock_guard lock( m_Mutex );
+        m_Presented = fence;
+    }
+    m_Condition.notify_all();
+}
+
+uint64_t FramePipeline::getSubmittedFence() const noexcept
+{
+    std::lock_guard lock( m_Mutex );
+    return m_Submitted;
+}
+
+uint64_t FramePipeline::getCompletedFence() const noexcept
+{
+    std::lock_guard lock( m_Mutex );
+    return m_Completed;
+}
+
+void FramePipeline::wait( uint64_t fence ) const
+{
+    std::unique_lock lock( m_Mutex );
+    m_Condition.wait( lock, [this, fence] { return m_Completed >= fence || m_Stop; } );
+}
+
+const Image& FramePipeline::getFrame( uint64_t fence ) const noexcept
+{
+    assert( fence > 0 );
+    return m_Frames[( fence - 1 ) % m_Frames.size()].image;
+}
+
+void FramePipeline::run()
+{
+    Rasterizer rasterizer;
+
+    while ( true )
+    {
+        Frame* frame = nullptr;
+        {
+            std::unique_lock lock( m_Mutex );
+            m_Condition.wait( lock, [this] { return m_Completed < m_Submitted || m_Stop; } );
+
+            if ( m_Stop )
+                return;
+
+            frame = &m_Frames[m_Completed % m_Frames.size()];
+        }
+
+        // Rasterize the frame with binning, so the tiles are rasterized in parallel.
+        rasterizer.state.colorTarget = &frame->image;
+        rasterizer.beginBinning();
+        rasterizer.execute( frame->commands );
+        rasterizer.endBinning();
+
+        frame->commands.clear();
+
+        {
+            std::lock_guard lock( m_Mutex );
+            ++m_Completed;
+        }
+        m_Condition.notify_all();
+    }
+}
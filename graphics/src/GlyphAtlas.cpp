@@ -0,0 +1,149 @@
+#include <graphics/GlyphAtlas.hpp>
+
+#include <SDL3/SDL_stdinc.h>
+#include <SDL3/SDL_surface.h>
+#include <SDL3_ttf/SDL_ttf.h>
+
+#include <stb_rect_pack.h>
+
+#include <cstring>  // For std::memcpy
+#include <iostream>
+
+using namespace sr::graphics;
+
+struct GlyphAtlas::Page
+{
+    Page()
+    : image { PageSize, PageSize, Color { 255, 255, 255, 0 } }
+    , nodes( PageSize )
+    {
+        stbrp_init_target( &context, PageSize, PageSize, nodes.data(), static_cast<int>( nodes.size() ) );
+    }
+
+    Image                   image;
+    stbrp_context           context {};
+    std::vector<stbrp_node> nodes;
+};
+
+GlyphAtlas::GlyphAtlas( TTF_Font* fillFont, TTF_Font* outlineFont )
+: m_FillFont { fillFont }
+, m_OutlineFont { outlineFont }
+{}
+
+GlyphAtlas::~GlyphAtlas() = default;
+
+std::vector<GlyphAtlas::Quad> GlyphAtlas::layout( std::string_view text, int x, int y )
+{
+    const int outline     = TTF_GetFontOutline( m_OutlineFont );
+    const int lineSpacing = TTF_GetFontLineSkip( m_FillFont );
+    const int charSpacing = TTF_GetFontCharSpacing( m_FillFont );
+
+    std::vector<Quad> fillQuads;
+    std::vector<Quad> outlineQuads;
+
+    glm::ivec2 pen { x, y };
+    uint32_t   previous = 0;
+
+    const char* str    = text.data();
+    size_t      length = text.size();
+    while ( length > 0 )
+    {
+        const uint32_t codepoint = SDL_StepUTF8( &str, &length );
+
+        if ( codepoint == '\n' )
+        {
+            pen      = { x, pen.y + lineSpacing };
+            previous = 0;
+            continue;
+        }
+
+        if ( previous )
+        {
+            int kerning = 0;
+            if ( TTF_GetGlyphKerning( m_FillFont, previous, codepoint, &kerning ) )
+                pen.x += kerning;
+        }
+
+        if ( outline > 0 )
+        {
+            const Glyph& glyph = getGlyph( codepoint, true );
+            if ( glyph.page )
+                outlineQuads.push_back( { glyph.page, glyph.rect, pen - outline, true } );
+        }
+
+        const Glyph& glyph = getGlyph( codepoint, false );
+        if ( glyph.page )
+            fillQuads.push_back( { glyph.page, glyph.rect, pen, false } );
+
+        pen.x += glyph.advance + charSpacing;
+        previous = codepoint;
+    }
+
+    outlineQuads.insert( outlineQuads.end(), fillQuads.begin(), fillQuads.end() );
+
+    return outlineQuads;
+}
+
+const GlyphAtlas::Glyph& GlyphAtlas::getGlyph( uint32_t codepoint, bool outline )
+{
+    const uint64_t key = codepoint | ( static_cast<uint64_t>( outline ) << 32 );
+
+    auto iter = m_Glyphs.find( key );
+    if ( iter == m_Glyphs.end() )
+        iter = m_Glyphs.emplace( key, addGlyph( codepoint, outline ) ).first;
+
+    return iter->second;
+}
+
+GlyphAtlas::Glyph GlyphAtlas::addGlyph( uint32_t codepoint, bool outline )
+{
+    TTF_Font* font = outline ? m_OutlineFont : m_FillFont;
+
+    Glyph glyph;
+    TTF_GetGlyphMetrics( m_FillFont, codepoint, nullptr, nullptr, nullptr, nullptr, &glyph.advance );
+
+    // Render the glyph in white, so it can be tinted with the text color.
+    SDL_Surface* rendered = TTF_RenderGlyph_Blended( font, codepoint, SDL_Color { 255, 255, 255, 255 } );
+    if ( !rendered )
+        return glyph;  // For example, whitespace doesn't have any pixels.
+
+    SDL_Surface* surface = SDL_ConvertSurface( rendered, SDL_PIXELFORMAT_RGBA32 );
+    SDL_DestroySurface( rendered );
+
+    if ( !surface )
+    {
+        std::cerr << "Failed to convert glyph surface: " << SDL_GetError() << std::endl;
+        return glyph;
+    }
+
+    // Leave a 1 pixel gap between the glyphs.
+    stbrp_rect rect {};
+    rect.w = surface->w + 1;
+    rect.h = surface->h + 1;
+
+    // Glyphs are only added to the last page. A new page is started when it is full.
+    if ( m_Pages.empty() || !stbrp_pack_rects( &m_Pages.back()->context, &rect, 1 ) )
+    {
+        m_Pages.push_back( std::make_unique<Page>() );
+        if ( !stbrp_pack_rects( &m_Pages.back()->context, &rect, 1 ) )
+        {
+            std::cerr << "Glyph " << codepoint << " is too large for the glyph atlas." << std::endl;
+            SDL_DestroySurface( surface );
+            return glyph;
+        }
+    }
+
+    Image& page = m_Pages.back()->image;
+    for ( int row = 0; row < surface->h; ++row )
+    {
+        const auto* src = static_cast<const std::byte*>( surface->pixels ) + static_cast<size_t>( row ) * surface->pitch;
+        std::memcpy( page.data() + static_cast<size_t>( rect.y + row ) * PageSize + rect.x, src, static_cast<size_t>( surface->w ) * sizeof( Color ) );
+    }
+
+    glyph.page = &page;
+    glyph.rect = math::RectI { rect.x, rect.y, surface->w, surface->h };
+
+    SDL_DestroySurface( surface );
+
+    return glyph;
+}
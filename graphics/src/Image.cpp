@@ -1,4 +1,7 @@
 #include <graphics/Image.hpp>
+#include <algorithm>
+#include <atomic>
+#include <cmath>
 #include <iostream>
 
 #include <stb_image.h>
@@ -9,15 +12,59 @@
 
 using namespace sr::graphics;
 
+struct Image::LazyClear
+{
+    enum TileState : uint8_t
+    {
+        Resolved,   // The pixels of the tile are valid.
+        Pending,    // The tile still needs to be cleared.
+        Resolving,  // The tile is being cleared by another thread.
+    };
+
+    LazyClear( int columns, int rows )
+    : columns { columns }
+    , rows { rows }
+    , tiles { std::make_unique<std::atomic<uint8_t>[]>( static_cast<size_t>( columns ) * rows ) }
+    {}
+
+    int                                     columns;
+    int                                     rows;
+    Color                                   color;
+    std::atomic<int>                        pending = 0;  // The number of pending tiles.
+    std::unique_ptr<std::atomic<uint8_t>[]> tiles;
+};
+
+// Compute the range of tiles [minX, maxX] x [minY, maxY] of an image that overlap a region (rounded out to whole pixels).
+// Returns false if the region doesn't overlap the image.
+static bool tileRange( const sr::math::AABB& aabb, int width, int height, int tileSize, int& minX, int& minY, int& maxX, int& maxY )
+{
+    const int x0 = std::max( static_cast<int>( std::floor( aabb.min.x ) ), 0 );
+    const int y0 = std::max( static_cast<int>( std::floor( aabb.min.y ) ), 0 );
+    const int x1 = std::min( static_cast<int>( std::ceil( aabb.max.x ) ), width - 1 );
+    const int y1 = std::min( static_cast<int>( std::ceil( aabb.max.y ) ), height - 1 );
+
+    if ( x0 > x1 || y0 > y1 )
+        return false;
+
+    minX = x0 / tileSize;
+    minY = y0 / tileSize;
+    maxX = x1 / tileSize;
+    maxY = y1 / tileSize;
+
+    return true;
+}
+
 Image::Image()  = default;
 Image::~Image() = default;
 
 Image::Image( const Image& copy )
 {
-    if ( copy.m_Pixels )
+    if ( copy.m_Data )
     {
+        copy.resolveClear();
         resize( copy.m_Width, copy.m_Height );
-        std::memcpy( m_Pixels.get(), copy.m_Pixels.get(), static_cast<size_t>( m_Width ) * m_Height * sizeof( Color ) );
+        std::memcpy( m_Data, copy.m_Data, static_cast<size_t>( m_Width ) * m_Height * sizeof( Color ) );
+        markDirty();
     }
 }
 
@@ -28,7 +75,15 @@ Image::Image( Image&& other ) noexcept
 , m_Width( std::exchange( other.m_Width, 0 ) )
 , m_Height( std::exchange( other.m_Height, 0 ) )
 , m_Pixels( std::move( other.m_Pixels ) )
-{}
+, m_Data( std::exchange( other.m_Data, nullptr ) )
+, m_LazyClear( std::move( other.m_LazyClear ) )
+, m_DirtyTiles( std::move( other.m_DirtyTiles ) )
+, m_DirtyColumns( std::exchange( other.m_DirtyColumns, 0 ) )
+, m_DirtyRows( std::exchange( other.m_DirtyRows, 0 ) )
+{
+    // The image may be presented at a different address, so it is uploaded again.
+    markDirty();
+}
 
 Image::Image( const std::filesystem::path& fileName )
 {
@@ -41,7 +96,7 @@ Image::Image( const std::filesystem::path& fileName )
     }
 
     resize( static_cast<uint32_t>( w ), static_cast<uint32_t>( h ) );
-    std::memcpy( m_Pixels.get(), data, static_cast<size_t>( m_Width ) * m_Height * sizeof( Color ) );
+    std::memcpy( m_Data, data, static_cast<size_t>( m_Width ) * m_Height * sizeof( Color ) );
 
     stbi_image_free( data );
 }
@@ -55,15 +110,33 @@ Image::Image( uint32_t width, uint32_t height, std::optional<Color> color )
     }
 }
 
+Image::Image( Color* pixels, uint32_t width, uint32_t height )
+: m_Data( pixels )
+{
+    setSize( width, height );
+}
+
+void Image::setView( Color* pixels ) noexcept
+{
+    assert( isView() );
+
+    cancelClear();
+    m_Data = pixels;
+    markDirty();
+}
+
 Image& Image::operator=( const Image& copy )
 {
     if ( this == &copy )
         return *this;
 
-    if ( copy.m_Pixels )
+    if ( copy.m_Data )
     {
+        copy.resolveClear();
         resize( copy.m_Width, copy.m_Height );
-        std::memcpy( m_Pixels.get(), copy.m_Pixels.get(), static_cast<size_t>( copy.m_Width ) * copy.m_Height * sizeof( Color ) );
+        cancelClear();
+        std::memcpy( m_Data, copy.m_Data, static_cast<size_t>( copy.m_Width ) * copy.m_Height * sizeof( Color ) );
+        markDirty();
     }
 
     return *this;
@@ -74,75 +147,61 @@ Image& Image::operator=( Image&& other ) noexcept
     if ( this == &other )
         return *this;
 
-    widthInfo  = std::exchange( other.widthInfo, {} );
-    heightInfo = std::exchange( other.heightInfo, {} );
-    m_AABB     = std::exchange( other.m_AABB, {} );
-    m_Width    = std::exchange( other.m_Width, 0 );
-    m_Height   = std::exchange( other.m_Height, 0 );
-    m_Pixels   = std::move( other.m_Pixels );
+    widthInfo      = std::exchange( other.widthInfo, {} );
+    heightInfo     = std::exchange( other.heightInfo, {} );
+    m_AABB         = std::exchange( other.m_AABB, {} );
+    m_Width        = std::exchange( other.m_Width, 0 );
+    m_Height       = std::exchange( other.m_Height, 0 );
+    m_Pixels       = std::move( other.m_Pixels );
+    m_Data         = std::exchange( other.m_Data, nullptr );
+    m_LazyClear    = std::move( other.m_LazyClear );
+    m_DirtyTiles   = std::move( other.m_DirtyTiles );
+    m_DirtyColumns = std::exchange( other.m_DirtyColumns, 0 );
+    m_DirtyRows    = std::exchange( other.m_DirtyRows, 0 );
+    markDirty();
 
     return *this;
 }
 
 const Color& Image::sample( int u, int v, const SamplerState& samplerState ) const noexcept
 {
-    const int w = m_Width;
-    const int h = m_Height;
-
     switch ( samplerState.addressMode )
     {
     case AddressMode::Wrap:
-        // Optimized wrap using bitwise operations for power-of-2, fast mod otherwise
-        if ( widthInfo.isPowerOf2 )
-            u = u & widthInfo.mask;  // Extremely fast for power-of-2
-        else
-            u = fast_mod_signed( u, w );
-
-        if ( heightInfo.isPowerOf2 )
-            v = v & heightInfo.mask;
-        else
-            v = fast_mod_signed( v, h );
-        break;
+        return sample<AddressMode::Wrap>( u, v, samplerState );
     case AddressMode::Mirror:
-        u = mirror_coord( u, w );
-        v = mirror_coord( v, h );
-        break;
+        return sample<AddressMode::Mirror>( u, v, samplerState );
     case AddressMode::Clamp:
-        // Branchless clamping - often faster than std::clamp due to avoided branches
-        u = u < 0 ? 0 : ( u >= w ? w - 1 : u );
-        v = v < 0 ? 0 : ( v >= h ? h - 1 : v );
-        break;
+        return sample<AddressMode::Clamp>( u, v, samplerState );
     case AddressMode::Border:
-        if ( u < 0 || u >= w || v < 0 || v >= h )
-            return samplerState.borderColor;
-        break;
+        return sample<AddressMode::Border>( u, v, samplerState );
     }
 
-    assert( u >= 0 && u < w );
-    assert( v >= 0 && v < h );
-
-    return m_Pixels[v * m_Width + u];
+    return sample<AddressMode::Wrap>( u, v, samplerState );
 }
 
 void Image::save( const std::filesystem::path& file ) const
 {
     const auto extension = file.extension();
 
+    // Clear the tiles that were not drawn to since the last fast clear.
+    resolveClear();
+
     if ( extension == ".png" )
     {
-        stbi_write_png( file.string().c_str(), m_Width, m_Height, 4, m_Pixels.get(), m_Width * static_cast<int>( sizeof( Color ) ) );
+        stbi_write_png( file.string().c_str(), m_Width, m_Height, 4, m_Data, m_Width * static_cast<int>( sizeof( Color ) ) );
     }
     else if ( extension == ".bmp" )
     {
-        stbi_write_bmp( file.string().c_str(), m_Width, m_Height, 4, m_Pixels.get() );
+        stbi_write_bmp( file.string().c_str(), m_Width, m_Height, 4, m_Data );
     }
     else if ( extension == ".tga" )
     {
-        stbi_write_tga( file.string().c_str(), m_Width, m_Height, 4, m_Pixels.get() );
+        stbi_write_tga( file.string().c_str(), m_Width, m_Height, 4, m_Data );
     }
     else if ( extension == ".jpg" )
     {
-        stbi_write_jpg( file.string().c_str(), m_Width, m_Height, 4, m_Pixels.get(), 10 );
+        stbi_write_jpg( file.string().c_str(), m_Width, m_Height, 4, m_Data, 10 );
     }
     else
     {
@@ -152,6 +211,9 @@ void Image::save( const std::filesystem::path& file ) const
 
 void Image::clear( const Color& color ) noexcept
 {
+    cancelClear();
+    markDirty();
+
     const size_t count = static_cast<size_t>( m_Width ) * m_Height;
     const uint8_t r = color.channels.r;
 
@@ -159,12 +221,12 @@ void Image::clear( const Color& color ) noexcept
     // memset is dramatically faster than element-wise fill.
     if ( r == color.channels.g && r == color.channels.b && r == color.channels.a )
     {
-        std::memset( m_Pixels.get(), r, count * sizeof( Color ) );
+        std::memset( m_Data, r, count * sizeof( Color ) );
     }
     else
     {
         // General path: fill via uint32_t to help the compiler vectorize.
-        auto* dst = reinterpret_cast<uint32_t*>( m_Pixels.get() );
+        auto* dst = reinterpret_cast<uint32_t*>( m_Data );
         const uint32_t val = color.rgba;
         for ( size_t i = 0; i < count; ++i )
             dst[i] = val;
@@ -172,14 +234,29 @@ void Image::clear( const Color& color ) noexcept
 }
 
 void Image::resize( uint32_t width, uint32_t height )
+{
+    if ( m_Data && std::cmp_equal( m_Width, width ) && std::cmp_equal( m_Height, height ) )
+        return;
+
+    m_Pixels = make_aligned_unique<Color[], 64>( static_cast<size_t>( width ) * height );
+    m_Data   = m_Pixels.get();
+
+    setSize( width, height );
+}
+
+void Image::setSize( uint32_t width, uint32_t height )
 {
     assert( width < INT_MAX );
     assert( height < INT_MAX );
 
-    if ( m_Pixels && std::cmp_equal( m_Width, width ) && std::cmp_equal( m_Height, height ) )
-        return;
+    m_LazyClear.reset();
 
-    m_Pixels = make_aligned_unique<Color[], 64>( static_cast<size_t>( width ) * height );
+    // A new image is dirty.
+    m_DirtyColumns = static_cast<int>( ( width + DirtyTileSize - 1 ) / DirtyTileSize );
+    m_DirtyRows    = static_cast<int>( ( height + DirtyTileSize - 1 ) / DirtyTileSize );
+    m_DirtyTiles   = std::make_unique<std::atomic<uint8_t>[]>( static_cast<size_t>( m_DirtyColumns ) * m_DirtyRows );
+    for ( int i = 0; i < m_DirtyColumns * m_DirtyRows; ++i )
+        m_DirtyTiles[i].store( 1, std::memory_order_relaxed );
 
     m_Width    = static_cast<int>( width );
     m_Height   = static_cast<int>( height );
@@ -191,4 +268,158 @@ void Image::resize( uint32_t width, uint32_t height )
         { 0, 0, 0 },
         { m_Width - 1, m_Height - 1, 0 }
     };
-}
\ No newline at end of file
+}
+
+void Image::fastClear( const Color& color )
+{
+    if ( !m_Data )
+        return;
+
+    if ( !m_LazyClear )
+        m_LazyClear = std::make_unique<LazyClear>( ( m_Width + ClearTileSize - 1 ) / ClearTileSize, ( m_Height + ClearTileSize - 1 ) / ClearTileSize );
+
+    LazyClear&   lazy  = *m_LazyClear;
+    const size_t count = static_cast<size_t>( lazy.columns ) * lazy.rows;
+
+    lazy.color = color;
+    for ( size_t i = 0; i < count; ++i )
+        lazy.tiles[i].store( LazyClear::Pending, std::memory_order_relaxed );
+
+    lazy.pending.store( static_cast<int>( count ), std::memory_order_release );
+
+    markDirty();
+}
+
+void Image::cancelClear() noexcept
+{
+    if ( !m_LazyClear || m_LazyClear->pending.load( std::memory_order_relaxed ) == 0 )
+        return;
+
+    LazyClear&   lazy  = *m_LazyClear;
+    const size_t count = static_cast<size_t>( lazy.columns ) * lazy.rows;
+
+    for ( size_t i = 0; i < count; ++i )
+        lazy.tiles[i].store( LazyClear::Resolved, std::memory_order_relaxed );
+
+    lazy.pending.store( 0, std::memory_order_release );
+}
+
+void Image::resolveTiles( const AABB& aabb, const AABB* overwritten ) const
+{
+    LazyClear& lazy = *m_LazyClear;
+
+    if ( lazy.pending.load( std::memory_order_acquire ) == 0 )
+        return;
+
+    int minX, minY, maxX, maxY;
+    if ( !tileRange( aabb, m_Width, m_Height, ClearTileSize, minX, minY, maxX, maxY ) )
+        return;
+
+    for ( int ty = minY; ty <= maxY; ++ty )
+    {
+        for ( int tx = minX; tx <= maxX; ++tx )
+        {
+            std::atomic<uint8_t>& tile = lazy.tiles[ty * lazy.columns + tx];
+
+            const int x      = tx * ClearTileSize;
+            const int y      = ty * ClearTileSize;
+            const int width  = std::min( ClearTileSize, m_Width - x );
+            const int height = std::min( ClearTileSize, m_Height - y );
+
+            // The tile doesn't need to be cleared if all of its pixels are overwritten.
+            const bool isOverwritten = overwritten && overwritten->min.x <= x && overwritten->min.y <= y && overwritten->max.x >= x + width - 1 && overwritten->max.y >= y + height - 1;
+
+            uint8_t expected = LazyClear::Pending;
+            if ( tile.compare_exchange_strong( expected, isOverwritten ? LazyClear::Resolved : LazyClear::Resolving, std::memory_order_acquire ) )
+            {
+                if ( !isOverwritten )
+                {
+                    for ( int row = y; row < y + height; ++row )
+                        std::fill_n( m_Data + static_cast<size_t>( row ) * m_Width + x, width, lazy.color );
+
+                    tile.store( LazyClear::Resolved, std::memory_order_release );
+                    tile.notify_all();
+                }
+
+                lazy.pending.fetch_sub( 1, std::memory_order_release );
+            }
+            else
+            {
+                // Another thread is clearing the tile.
+                while ( expected == LazyClear::Resolving )
+                {
+                    tile.wait( LazyClear::Resolving, std::memory_order_acquire );
+                    expected = tile.load( std::memory_order_acquire );
+                }
+            }
+        }
+    }
+}
+
+void Image::markDirty( const AABB& aabb ) noexcept
+{
+    int minX, minY, maxX, maxY;
+    if ( !tileRange( aabb, m_Width, m_Height, DirtyTileSize, minX, minY, maxX, maxY ) )
+        return;
+
+    for ( int ty = minY; ty <= maxY; ++ty )
+    {
+        for ( int tx = minX; tx <= maxX; ++tx )
+        {
+            std::atomic<uint8_t>& tile = m_DirtyTiles[ty * m_DirtyColumns + tx];
+            if ( !tile.load( std::memory_order_relaxed ) )
+                tile.store( 1, std::memory_order_relaxed );
+        }
+    }
+}
+
+std::vector<sr::math::RectI> Image::takeDirtyRects() const
+{
+    std::vector<math::RectI> rects;
+    std::vector<size_t>      previousRow;  // The rectangles that end at the previous row of tiles.
+    std::vector<size_t>      currentRow;
+
+    for ( int ty = 0; ty < m_DirtyRows; ++ty )
+    {
+        const int y      = ty * DirtyTileSize;
+        const int height = std::min( DirtyTileSize, m_Height - y );
+
+        currentRow.clear();
+
+        for ( int tx = 0; tx < m_DirtyColumns; )
+        {
+            if ( !m_DirtyTiles[ty * m_DirtyColumns + tx].exchange( 0, std::memory_order_relaxed ) )
+            {
+                ++tx;
+                continue;
+            }
+
+            // Find the end of the run of dirty tiles.
+            int end = tx + 1;
+            while ( end < m_DirtyColumns && m_DirtyTiles[ty * m_DirtyColumns + end].exchange( 0, std::memory_order_relaxed ) )
+                ++end;
+
+            const int x     = tx * DirtyTileSize;
+            const int width = std::min( end * DirtyTileSize, m_Width ) - x;
+
+            // Extend the rectangle of the previous row if it covers the same columns.
+            auto above = std::ranges::find_if( previousRow, [&]( size_t i ) { return rects[i].left == x && rects[i].width == width; } );
+            if ( above != previousRow.end() )
+            {
+                rects[*above].height += height;
+                currentRow.push_back( *above );
+            }
+            else
+            {
+                currentRow.push_back( rects.size() );
+                rects.emplace_back( x, y, width, height );
+            }
+
+            tx = end;
+        }
+
+        std::swap( previousRow, currentRow );
+    }
+
+    return rects;
+}
@@ -1,39 +1,153 @@
-#include <SDL_ttf_context.hpp>
+#include <graphics/GlyphAtlas.hpp>
 #include <graphics/Rasterizer.hpp>
+#include <graphics/ThreadPool.hpp>
 #include <graphics/Vertex.hpp>
 
-#include <SDL3_ttf/SDL_ttf.h>
-
 #define GLM_ENABLE_EXPERIMENTAL
 #include "graphics/ResourceManager.hpp"
 
 #include <glm/gtx/matrix_query.hpp>  // glm::isIdentity.
+#include <math/Intrinsics.hpp>
 
 #include <algorithm>
-#include <execution>
+#include <cassert>
 #include <iostream>
+#include <limits>
+#include <mutex>
 #include <ranges>
+#include <vector>
 
 using namespace sr::graphics;
 using namespace sr::math;
 
+// Number of fractional bits of fixed-point texture coordinates (16.16).
+constexpr int FixedShift = 16;
+
+// Convert a value to 16.16 fixed-point.
+// Returns false if the value is not (up to rounding errors) a multiple of 1/65536,
+// or if the value is too large to be stepped across the screen without overflow.
+static bool toFixed( double value, int& fixed )
+{
+    const double scaled  = value * ( 1 << FixedShift );
+    const double rounded = std::round( scaled );
+
+    if ( std::abs( scaled - rounded ) > 1e-3 || std::abs( rounded ) >= ( 1 << 30 ) )
+        return false;
+
+    fixed = static_cast<int>( rounded );
+    return true;
+}
+
+// Convert texture coordinates to 16.16 fixed-point.
+static glm::ivec2 toFixed( const glm::vec2& texCoord )
+{
+    return glm::ivec2 { glm::round( texCoord * static_cast<float>( 1 << FixedShift ) ) };
+}
+
+// An attribute that is linearly interpolated across a triangle.
+// The value of the attribute at an offset (x, y) (in pixels) from the starting pixel of the
+// edge functions is a0 + stepX * x + stepY * y. Moving to the next pixel in a row adds stepX,
+// and moving to the next row adds stepY.
+template<typename T>
+struct Plane
+{
+    T a0;     // Value at the starting pixel.
+    T stepX;  // Delta for each pixel in the x direction.
+    T stepY;  // Delta for each pixel in the y direction.
+
+    T at( int x, int y ) const
+    {
+        return a0 + stepX * x + stepY * y;
+    }
+};
+
+// Used by draw calls that don't interpolate any attributes across the triangle.
+struct NoVaryings
+{
+    NoVaryings operator+( const NoVaryings& ) const
+    {
+        return {};
+    }
+
+    NoVaryings operator*( int ) const
+    {
+        return {};
+    }
+};
+
+// Texture coordinates and color that are interpolated across a triangle.
+// TexCoord is either glm::vec2, or glm::ivec2 for 16.16 fixed-point texture coordinates.
+template<typename TexCoord>
+struct Varyings
+{
+    TexCoord  texCoord;
+    glm::vec4 color;  // Color channels in the range [0...255].
+
+    Varyings operator+( const Varyings& rhs ) const
+    {
+        return { texCoord + rhs.texCoord, color + rhs.color };
+    }
+
+    Varyings operator*( int s ) const
+    {
+        return { texCoord * TexCoord( s ), color * static_cast<float>( s ) };
+    }
+};
+
+template<typename TexCoord>
+static Plane<Varyings<TexCoord>> makePlane( const Plane<TexCoord>& texCoord, const Plane<glm::vec4>& color )
+{
+    return {
+        { texCoord.a0, color.a0 },
+        { texCoord.stepX, color.stepX },
+        { texCoord.stepY, color.stepY },
+    };
+}
+
+static glm::vec4 toVec4( const Color& c )
+{
+    return { c.channels.r, c.channels.g, c.channels.b, c.channels.a };
+}
+
+// Convert an interpolated color to a Color.
+static Color toColor( const glm::vec4& c )
+{
+    return {
+        static_cast<uint8_t>( std::clamp( c.r, 0.0f, 255.0f ) ),
+        static_cast<uint8_t>( std::clamp( c.g, 0.0f, 255.0f ) ),
+        static_cast<uint8_t>( std::clamp( c.b, 0.0f, 255.0f ) ),
+        static_cast<uint8_t>( std::clamp( c.a, 0.0f, 255.0f ) ),
+    };
+}
+
 // 2D Edge functions for triangle rasterization.
 // See: https://fgiesen.wordpress.com/2013/02/08/triangle-rasterization-in-practice/
 struct Edge2D
 {
+    // Coverage of a block of pixels.
+    enum class Coverage
+    {
+        None,     // The block is completely outside of the triangle.
+        Partial,  // The block is partially covered by the triangle.
+        Full,     // The block is completely inside of the triangle.
+    };
+
     glm::ivec3 dX;       // X deltas.
     glm::ivec3 dY;       // Y deltas.
-    glm::ivec3 w0;       // Starting weights per row.
-    glm::ivec3 w;        // Current weight.
+    glm::ivec3 w0;       // Weights at the starting pixel.
+    glm::ivec3 bias;     // Integer adjustment of the weights (fill rule bias and rounded half-pixel offset).
+    int        area;     // Twice the area of the triangle.
     float      invArea;  // Reciprocal of the area of the triangle (used to compute the barycentric coordinates).
 
     Edge2D( const glm::ivec2& p0, const glm::ivec2& p1, const glm::ivec2& p2, const glm::ivec2& p )
     : dX { p2.x - p1.x, p0.x - p2.x, p1.x - p0.x }
     , dY { p1.y - p2.y, p2.y - p0.y, p0.y - p1.y }
     {
-        invArea  = 1.0f / static_cast<float>( orient2D( p0, p1, p2 ) );
+        area     = orient2D( p0, p1, p2 );
+        invArea  = 1.0f / static_cast<float>( area );
         int sign = invArea < 0.0f ? -1 : 1;  // Determine the sign of the area to handle back-facing triangles.
 
+        area *= sign;
         invArea *= static_cast<float>( sign );  // Make invArea positive for consistent weight calculations.
         dX *= sign;
         dY *= sign;
@@ -61,271 +175,1947 @@ struct Edge2D
         // Adding 0.5 to p.x and p.y means we add: 0.5 * (b.x - a.x - b.y + a.y)
         w0 += ( dX + dY ) / 2;  // Half-pixel offset
 
-        w = w0;
+        bias = glm::ivec3 { bias0, bias1, bias2 } + ( dX + dY ) / 2;
     }
 
-    bool inside() const
+    // The exact (unbiased) value of a weight at the center of the starting pixel.
+    // Used to interpolate attributes, which should not be affected by the fill rule.
+    double centerWeight( int i ) const
     {
-        return ( w.x | w.y | w.z ) >= 0;  // Check if all weights are non-negative.
+        return static_cast<double>( w0[i] - bias[i] ) + 0.5 * ( dX[i] + dY[i] );
     }
 
-    void stepX()
+    static bool inside( const glm::ivec3& weights )
     {
-        w += dY;
+        return ( weights.x | weights.y | weights.z ) >= 0;  // Check if all weights are non-negative.
     }
 
-    void stepY()
+    // Evaluate the edge functions at an offset (in pixels) from the starting pixel.
+    glm::ivec3 weightsAt( int x, int y ) const
     {
-        w0 += dX;
-        w = w0;
+        return w0 + dY * x + dX * y;
     }
 
-    glm::vec3 barycentric() const
+    // Compute the range of pixels [first, last] in a row of width pixels that are inside of the triangle,
+    // where weights are the values of the edge functions at the first pixel of the row.
+    // The range is exact: a pixel x is in the range if and only if inside( weights + dY * x ),
+    // so it follows the same top-left fill rule as the per-pixel test.
+    // Returns false if none of the pixels in the row are inside of the triangle.
+    bool span( const glm::ivec3& weights, int width, int& first, int& last ) const
     {
-        float u = static_cast<float>( w.x ) * invArea;
-        float v = static_cast<float>( w.y ) * invArea;
+        first = 0;
+        last  = width - 1;
 
-        return { u, v, 1.0f - ( u + v ) };
-    }
-};
+        for ( int i = 0; i < 3; ++i )
+        {
+            // weights[i] + dY[i] * x >= 0
+            if ( dY[i] > 0 )
+                first = std::max( first, -floor_div( weights[i], dY[i] ) );
+            else if ( dY[i] < 0 )
+                last = std::min( last, floor_div( weights[i], -dY[i] ) );
+            else if ( weights[i] < 0 )
+                return false;
+        }
 
-void Rasterizer::drawText( std::shared_ptr<const Font> font, std::string_view str, int x, int y ) const
-{
-#if 1
-    return drawText( Text { std::move(font), str, state.color, state.outlineColor }, x, y );
-#else
-    Image* image = state.colorTarget;
+        return first <= last;
+    }
 
-    if ( !image )
-        return;
+    // Classify a block of pixels by evaluating the edge functions at the corners of the block.
+    // Since the edge functions are linear, their minimum and maximum over the block are at the corners.
+    Coverage classify( const glm::ivec3& weights, int width, int height ) const
+    {
+        const glm::ivec3 w00 = weights;
+        const glm::ivec3 w10 = weights + dY * ( width - 1 );
+        const glm::ivec3 w01 = weights + dX * ( height - 1 );
+        const glm::ivec3 w11 = w10 + dX * ( height - 1 );
+
+        // If all of the corners are outside of any one of the edges, the block is outside of the triangle.
+        const glm::ivec3 maxW = glm::max( glm::max( w00, w10 ), glm::max( w01, w11 ) );
+        if ( maxW.x < 0 || maxW.y < 0 || maxW.z < 0 )
+            return Coverage::None;
+
+        // If all of the corners are inside of all of the edges, the block is inside of the triangle.
+        const glm::ivec3 minW = glm::min( glm::min( w00, w10 ), glm::min( w01, w11 ) );
+        if ( inside( minW ) )
+            return Coverage::Full;
+
+        return Coverage::Partial;
+    }
 
-    SDL_Surface* surface = SDL_CreateSurfaceFrom( image->getWidth(), image->getHeight(), SDL_PIXELFORMAT_RGBA32, image->data(), image->getPitch() );
-    if ( !surface )
+    // Set up the plane equation of an attribute with the values a0, a1, and a2 at the vertices of the triangle.
+    // This gives the same result as interpolating the attribute with the barycentric coordinates of each pixel,
+    // but the attribute only needs to be set up once per triangle.
+    template<typename T>
+    Plane<T> plane( const T& a0, const T& a1, const T& a2 ) const
     {
-        std::cerr << "Failed to create surface from image: " << SDL_GetError() << std::endl;
-        return;
+        // a = a0 * b0 + a1 * b1 + a2 * ( 1 - b0 - b1 ) = a2 + ( a0 - a2 ) * b0 + ( a1 - a2 ) * b1
+        const T d0 = ( a0 - a2 ) * invArea;
+        const T d1 = ( a1 - a2 ) * invArea;
+
+        return {
+            a2 + d0 * static_cast<float>( centerWeight( 0 ) ) + d1 * static_cast<float>( centerWeight( 1 ) ),
+            d0 * static_cast<float>( dY.x ) + d1 * static_cast<float>( dY.y ),
+            d0 * static_cast<float>( dX.x ) + d1 * static_cast<float>( dX.y ),
+        };
     }
 
-    int outline = font.getOutline();
-    if ( outline > 0 )
+    // Set up the plane equation of the texture coordinates in 16.16 fixed-point.
+    // Returns false if the plane equation can't be represented exactly in fixed-point, or if
+    // the texture coordinates would overflow within width x height pixels of the starting pixel.
+    bool fixedPlane( const glm::vec2& a0, const glm::vec2& a1, const glm::vec2& a2, int width, int height, Plane<glm::ivec2>& plane ) const
     {
-        TTF_Text* text = TTF_CreateText( SDL_ttf_context::textEngine(), font.getTTF_OutlineFont(), str.data(), str.size() );
-        if ( !text )
+        if ( area == 0 )
+            return false;
+
+        for ( int i = 0; i < 2; ++i )
         {
-            std::cerr << "Failed to create outline text." << SDL_GetError() << std::endl;
+            const double d0    = ( static_cast<double>( a0[i] ) - a2[i] ) / area;
+            const double d1    = ( static_cast<double>( a1[i] ) - a2[i] ) / area;
+            const double a     = a2[i] + d0 * centerWeight( 0 ) + d1 * centerWeight( 1 );
+            const double stepX = d0 * dY.x + d1 * dY.y;
+            const double stepY = d0 * dX.x + d1 * dX.y;
+
+            int corner;
+            if ( !toFixed( a, plane.a0[i] ) || !toFixed( stepX, plane.stepX[i] ) || !toFixed( stepY, plane.stepY[i] ) || !toFixed( std::abs( a ) + std::abs( stepX ) * width + std::abs( stepY ) * height, corner ) )
+                return false;
         }
-        else
+
+        return true;
+    }
+};
+
+// Size (in pixels) of the blocks used for coarse rasterization.
+// A row of a block is tested with a single 8-wide coverage mask.
+constexpr int BlockSize = 8;
+
+// Rasterize the pixels in the range [minX, maxX] x [minY, maxY] that are covered by one or more triangles.
+// The edge functions and attribute planes of each triangle must be set up at (minX, minY).
+// The range is traversed in blocks of BlockSize x BlockSize pixels. Blocks that are outside of a triangle are skipped,
+// blocks that are inside of a triangle are filled without testing each pixel, and only the pixels of partially
+// covered blocks are tested against the edge functions.
+// The shader is invoked as shader( x, y, triangle, varyings ), where triangle is the index of the edge functions
+// that cover the pixel, and varyings are the interpolated attributes at the pixel.
+template<size_t N, typename T, typename Shader>
+static void rasterizeBlocks( const Edge2D ( &edges )[N], const Plane<T> ( &planes )[N], int minX, int minY, int maxX, int maxY, Shader&& shader )
+{
+    for ( int blockY = minY; blockY <= maxY; blockY += BlockSize )
+    {
+        const int blockHeight = std::min( BlockSize, maxY - blockY + 1 );
+
+        for ( int blockX = minX; blockX <= maxX; blockX += BlockSize )
         {
-            TTF_SetTextColor( text, state.outlineColor.channels.r, state.outlineColor.channels.g, state.outlineColor.channels.b, state.outlineColor.channels.a );
-            if ( !TTF_DrawSurfaceText( text, x - outline * 2, y - outline * 2, surface ) )
+            const int blockWidth = std::min( BlockSize, maxX - blockX + 1 );
+
+            for ( size_t i = 0; i < N; ++i )
             {
-                std::cerr << "Failed to draw outline text to the surface: " << SDL_GetError() << std::endl;
+                const Edge2D&    e       = edges[i];
+                const Plane<T>&  p       = planes[i];
+                const glm::ivec3 weights = e.weightsAt( blockX - minX, blockY - minY );
+
+                switch ( e.classify( weights, blockWidth, blockHeight ) )
+                {
+                case Edge2D::Coverage::None:
+                    break;
+                case Edge2D::Coverage::Full:
+                {
+                    T row = p.at( blockX - minX, blockY - minY );
+                    for ( int y = blockY; y < blockY + blockHeight; ++y )
+                    {
+                        T v = row;
+                        for ( int x = blockX; x < blockX + blockWidth; ++x )
+                        {
+                            shader( x, y, i, v );
+                            v = v + p.stepX;
+                        }
+                        row = row + p.stepY;
+                    }
+                }
+                break;
+                case Edge2D::Coverage::Partial:
+                {
+                    // Mask off the pixels that are past the right edge of the bounding box.
+                    const int  columnMask = ( 1 << blockWidth ) - 1;
+                    glm::ivec3 w          = weights;
+                    T          row        = p.at( blockX - minX, blockY - minY );
+                    for ( int y = blockY; y < blockY + blockHeight; ++y )
+                    {
+                        int mask = simd_edge_coverage_mask8( &w.x, &e.dY.x ) & columnMask;
+                        while ( mask )
+                        {
+                            const int x = count_trailing_zeros( mask );
+                            shader( blockX + x, y, i, row + p.stepX * x );
+                            mask &= mask - 1;  // Clear the lowest set bit.
+                        }
+                        w += e.dX;
+                        row = row + p.stepY;
+                    }
+                }
+                break;
+                }
             }
-            TTF_DestroyText( text );
         }
     }
+}
+
+// Invoke func( y, x0, x1, triangle ) for the span of pixels [x0, x1] that is covered by each triangle on each
+// scanline in the range [minX, maxX] x [minY, maxY]. The edge functions of each triangle must be set up at (minX, minY).
+// The spans are exact (see Edge2D::span), so the spans of triangles that share an edge don't overlap.
+template<size_t N, typename Func>
+static void forEachSpan( const Edge2D ( &edges )[N], int minX, int minY, int maxX, int maxY, Func&& func )
+{
+    const int width = maxX - minX + 1;
+
+    for ( int y = minY; y <= maxY; ++y )
     {
-        TTF_Text* text = TTF_CreateText( SDL_ttf_context::textEngine(), font.getTTF_FillFont(), str.data(), str.size() );
-        if ( !text )
+        for ( size_t i = 0; i < N; ++i )
         {
-            std::cerr << "Failed to create fill text." << SDL_GetError() << std::endl;
+            const Edge2D& e = edges[i];
+
+            int first, last;
+            if ( e.span( e.weightsAt( 0, y - minY ), width, first, last ) )
+                func( y, minX + first, minX + last, i );
         }
-        else
+    }
+}
+
+// Rasterize the pixels in the range [minX, maxX] x [minY, maxY] that are covered by one or more triangles
+// by computing the exact span of covered pixels of each triangle on each scanline.
+// Unlike rasterizeBlocks, no pixels outside of the triangles are visited. This is faster for rotated
+// and thin triangles that only cover a small part of their bounding box.
+// The shader is invoked the same way as for rasterizeBlocks.
+template<size_t N, typename T, typename Shader>
+static void rasterizeSpans( const Edge2D ( &edges )[N], const Plane<T> ( &planes )[N], int minX, int minY, int maxX, int maxY, Shader&& shader )
+{
+    forEachSpan( edges, minX, minY, maxX, maxY, [&]( int y, int x0, int x1, size_t i ) {
+        const Plane<T>& p = planes[i];
+
+        // The attributes are evaluated at the start of every BlockSize pixels, so rounding errors don't accumulate over long spans.
+        for ( int blockX = x0 - minX; blockX <= x1 - minX; blockX += BlockSize )
         {
-            TTF_SetTextColor( text, state.color.channels.r, state.color.channels.g, state.color.channels.b, state.color.channels.a );
-            if ( !TTF_DrawSurfaceText( text, x, y, surface ) )
+            T v = p.at( blockX, y - minY );
+            for ( int x = blockX; x <= std::min( x1 - minX, blockX + BlockSize - 1 ); ++x )
             {
-                std::cerr << "Failed to draw fill text to the surface: " << SDL_GetError() << std::endl;
+                shader( minX + x, y, i, v );
+                v = v + p.stepX;
             }
-            TTF_DestroyText( text );
         }
-    }
-    SDL_DestroySurface( surface );
-#endif
+    } );
 }
 
-void Rasterizer::drawText( std::string_view text, int x, int y ) const
+// Prepare a region of a color target before a draw call writes to it:
+// the tiles of a lazy clear are resolved (see Image::fastClear), and the region is marked as dirty (see Image::markDirty).
+// The pixels are written without marking them individually (see Image::plot).
+// If the draw call replaces every pixel of the overwritten region (for example, an opaque blit), the tiles
+// of the lazy clear that are completely inside of it are not cleared.
+static void beginWrite( Image& image, const AABB& aabb, const std::optional<AABB>& overwritten = {} )
 {
-    drawText( ResourceManager::loadFont(), text, x, y );
+    if ( overwritten )
+        image.resolveClear( aabb, aabb.clamped( *overwritten ) );
+    else
+        image.resolveClear( aabb );
+
+    image.markDirty( aabb );
 }
 
-void Rasterizer::drawText( const Text& text, int x, int y ) const
+// The region that a draw call overwrites with the blend mode: without blending, every pixel of the region is replaced.
+static std::optional<AABB> opaqueRegion( const BlendMode& blendMode, const AABB& region )
 {
-    Image* image = state.colorTarget;
+    if ( blendMode.getPipeline() != BlendPipeline::Disable )
+        return std::nullopt;
 
-    if ( !image )
-        return;
+    return region;
+}
 
-    text.draw( *image, x, y );
+// Fill the pixels [x0, x1] of row y with a constant color.
+// This is the same as plotting each pixel, but the row is filled (or blended) as a single span.
+static void fillSpan( Image& image, int y, int x0, int x1, const Color& color, const BlendMode& blendMode )
+{
+    blendMode.blendSpan( color, image.data() + static_cast<size_t>( y ) * image.getWidth() + x0, static_cast<size_t>( x1 - x0 + 1 ) );
 }
 
-// Source: Claud Sonnet 4 "Create a 2D Software Rasterizer in C++"
-void Rasterizer::drawLineLow( int x0, int y0, int x1, int y1 ) const
+// Invoke blit( x, n ) for each run of pixels [x, x + n) in the pixels [x0, x1] of row y
+// that aren't covered by the coverage mask. Without a coverage mask, the entire row is a single run.
+template<typename Blit>
+static void forEachVisibleSpan( const CoverageMask* coverageMask, int y, int x0, int x1, Blit&& blit )
 {
-    Image*    image     = state.colorTarget;
-    BlendMode blendMode = state.blendMode;
+    if ( coverageMask )
+        coverageMask->forEachUncovered( y, x0, x1, blit );
+    else
+        blit( x0, x1 - x0 + 1 );
+}
 
-    int dx = x1 - x0;
-    int dy = y1 - y0;
-    int yi = 1;
+// Mark the pixels [x, x + n) of row y as covered if the source colors (multiplied by the tint) replace the destination.
+// Only opaque blend modes cover pixels: with blending disabled every pixel is replaced,
+// and with alpha discard only the pixels that pass the alpha test are replaced.
+static void coverSpan( CoverageMask* coverageMask, const BlendMode& blendMode, int y, int x, const Color* src, int n, const Color& tint )
+{
+    if ( !coverageMask )
+        return;
 
-    if ( dy < 0 )
+    switch ( blendMode.getPipeline() )
     {
-        yi = -1;
-        dy = -dy;
-    }
-
-    int D = 2 * dy - dx;
-    int y = y0;
-
-    for ( int x = x0; x <= x1; ++x )
+    case BlendPipeline::Disable:
+        coverageMask->cover( y, x, x + n - 1 );
+        break;
+    case BlendPipeline::AlphaDiscard:
     {
-        image->plot<false>( x, y, state.color, blendMode );
+        const bool modulate = tint != Color::White;
 
-        if ( D > 0 )
+        // Cover the runs of pixels that pass the alpha test.
+        int first = -1;
+        for ( int i = 0; i <= n; ++i )
         {
-            y += yi;
-            D -= 2 * dx;
+            const bool opaque = i < n && ( modulate ? src[i] * tint : src[i] ).channels.a >= blendMode.alphaThreshold;
+            if ( opaque && first < 0 )
+            {
+                first = i;
+            }
+            else if ( !opaque && first >= 0 )
+            {
+                coverageMask->cover( y, x + first, x + i - 1 );
+                first = -1;
+            }
         }
-        D += 2 * dy;
+        break;
+    }
+    default:
+        break;
     }
 }
 
-void Rasterizer::drawLineHigh( int x0, int y0, int x1, int y1 ) const
+// Invoke func( dy, halfWidth ) for each row dy in [0, ry] of an ellipse with the radii rx and ry,
+// where [-halfWidth, halfWidth] is the range of pixels of the row that are inside of the ellipse.
+// The half-width of each row is stepped with integer arithmetic instead of computing a square root per row.
+template<typename Func>
+static void forEachEllipseRow( int rx, int ry, Func&& func )
 {
-    Image*    image     = state.colorTarget;
-    BlendMode blendMode = state.blendMode;
+    // A pixel (x, y) is inside of the ellipse if x^2 * ry^2 + y^2 * rx^2 <= rx^2 * ry^2.
+    const int64_t rx2 = static_cast<int64_t>( rx ) * rx;
+    const int64_t ry2 = static_cast<int64_t>( ry ) * ry;
 
-    int dx = x1 - x0;
-    int dy = y1 - y0;
-    int xi = 1;
-
-    if ( dx < 0 )
+    int x = rx;
+    for ( int y = 0; y <= ry; ++y )
     {
-        xi = -1;
-        dx = -dx;
+        while ( x >= 0 && x * x * ry2 + y * y * rx2 > rx2 * ry2 )
+            --x;
+
+        func( y, x );
     }
+}
+
+// Rasterize triangles without interpolating any attributes.
+template<size_t N, typename Shader>
+static void rasterizeBlocks( const Edge2D ( &edges )[N], int minX, int minY, int maxX, int maxY, Shader&& shader )
+{
+    const Plane<NoVaryings> planes[N] {};
+    rasterizeBlocks( edges, planes, minX, minY, maxX, maxY, std::forward<Shader>( shader ) );
+}
 
-    int D = 2 * dx - dy;
-    int x = x0;
+template<BlendPipeline Pipeline>
+using BlendPipelineConstant = std::integral_constant<BlendPipeline, Pipeline>;
 
-    for ( int y = y0; y <= y1; ++y )
+template<AddressMode Mode>
+using AddressModeConstant = std::integral_constant<AddressMode, Mode>;
+
+// Select the specialized pixel pipeline for the blend mode once per draw call.
+// The function is invoked as func( pipeline ), where pipeline is a std::integral_constant
+// that can be used as a template argument in the inner pixel loop.
+template<typename Func>
+static void dispatchBlend( const BlendMode& blendMode, Func&& func )
+{
+    switch ( blendMode.getPipeline() )
     {
-        image->plot<false>( x, y, state.color, blendMode );
+    case BlendPipeline::Disable:
+        func( BlendPipelineConstant<BlendPipeline::Disable> {} );
+        break;
+    case BlendPipeline::AlphaDiscard:
+        func( BlendPipelineConstant<BlendPipeline::AlphaDiscard> {} );
+        break;
+    case BlendPipeline::AlphaBlend:
+        func( BlendPipelineConstant<BlendPipeline::AlphaBlend> {} );
+        break;
+    case BlendPipeline::Additive:
+        func( BlendPipelineConstant<BlendPipeline::Additive> {} );
+        break;
+    case BlendPipeline::Generic:
+        func( BlendPipelineConstant<BlendPipeline::Generic> {} );
+        break;
+    }
+}
 
-        if ( D > 0 )
+// Select the specialized pixel pipeline for the blend mode and the address mode of the sampler once per draw call.
+// The function is invoked as func( pipeline, addressMode ).
+template<typename Func>
+static void dispatchPipeline( const BlendMode& blendMode, const SamplerState& samplerState, Func&& func )
+{
+    dispatchBlend( blendMode, [&]( auto pipeline ) {
+        switch ( samplerState.addressMode )
         {
-            x += xi;
-            D -= 2 * dy;
+        case AddressMode::Wrap:
+            func( pipeline, AddressModeConstant<AddressMode::Wrap> {} );
+            break;
+        case AddressMode::Mirror:
+            func( pipeline, AddressModeConstant<AddressMode::Mirror> {} );
+            break;
+        case AddressMode::Clamp:
+            func( pipeline, AddressModeConstant<AddressMode::Clamp> {} );
+            break;
+        case AddressMode::Border:
+            func( pipeline, AddressModeConstant<AddressMode::Border> {} );
+            break;
         }
+    } );
+}
 
-        D += 2 * dx;
-    }
+template<AddressMode Mode>
+static const Color& sampleTexture( const Image& texture, const glm::vec2& texCoord, const SamplerState& samplerState )
+{
+    return texture.sample<Mode>( texCoord.x, texCoord.y, samplerState );
 }
 
-void Rasterizer::clear( std::optional<Color> color ) const
+template<AddressMode Mode>
+static const Color& sampleTexture( const Image& texture, const glm::ivec2& texCoord, const SamplerState& samplerState )
 {
-    if ( Image* image = state.colorTarget )
-        image->clear( color.value_or( state.color ) );
+    return texture.sample<Mode>( texCoord.x >> FixedShift, texCoord.y >> FixedShift, samplerState );
 }
 
-void Rasterizer::drawLine( int x0, int y0, int x1, int y1 ) const
+template<size_t N, typename TexCoord>
+static void shadeTextured( Image& image, const Edge2D ( &edges )[N], const Plane<Varyings<TexCoord>> ( &planes )[N], int minX, int minY, int maxX, int maxY, bool spans, const TexCoord& minTexCoord, const TexCoord& maxTexCoord, const std::optional<Color>& flatColor, const Image& texture, const SamplerState& samplerState, const BlendMode& blendMode )
 {
-    Image* image = state.colorTarget;
+    dispatchPipeline( blendMode, samplerState, [&]( auto pipeline, auto addressMode ) {
+        auto shader = [&]( int x, int y, size_t, const Varyings<TexCoord>& v ) {
+            const TexCoord texCoord = glm::clamp( v.texCoord, minTexCoord, maxTexCoord );
+            const Color    color    = flatColor ? *flatColor : toColor( v.color );
+            const Color    srcColor = sampleTexture<addressMode>( texture, texCoord, samplerState ) * color;
+            image.plot<false, true, pipeline, false>( x, y, srcColor, blendMode );
+        };
 
-    if ( !image )
-        return;
+        if ( spans )
+            rasterizeSpans( edges, planes, minX, minY, maxX, maxY, shader );
+        else
+            rasterizeBlocks( edges, planes, minX, minY, maxX, maxY, shader );
+    } );
+}
 
-    auto aabb = image->getAABB();
-    aabb.clamp( AABB::fromViewport( state.viewport ) );
+// Rasterize textured triangles, where triangle i has the vertices verts[indices[i * 3 + 0...2]].
+// The texture coordinates and colors are set up as plane equations once per triangle and stepped from pixel to pixel.
+// The texture coordinates are stepped in 16.16 fixed-point if that is exact (for example, for unscaled sprites).
+template<size_t N>
+static void rasterizeTextured( Image& image, const Edge2D ( &edges )[N], const Vertex2D* verts, const uint32_t* indices, int minX, int minY, int maxX, int maxY, const Image& texture, const SamplerState& samplerState, const BlendMode& blendMode )
+{
+    // Compute valid texture coordinate bounds from vertices to prevent bleeding into tile margins
+    glm::vec2 minTexCoord = verts[indices[0]].texCoord;
+    glm::vec2 maxTexCoord = verts[indices[0]].texCoord;
+    bool      flat        = true;
 
-    if ( !aabb.clip( x0, y0, x1, y1 ) )
-        return;
+    for ( size_t i = 1; i < N * 3; ++i )
+    {
+        const Vertex2D& v = verts[indices[i]];
+
+        minTexCoord = glm::min( minTexCoord, v.texCoord );
+        maxTexCoord = glm::max( maxTexCoord, v.texCoord );
+        flat        = flat && v.color == verts[indices[0]].color;
+    }
+
+    // Vertices that all have the same color (usually white) don't need to interpolate the color.
+    const std::optional<Color> flatColor = flat ? std::optional { verts[indices[0]].color } : std::nullopt;
 
-    if ( std::abs( y1 - y0 ) < std::abs( x1 - x0 ) )
+    // Rotated and thin triangles cover only a small part of their bounding box. If the triangles cover less than
+    // 3/4 of the bounding box, only the covered span of each scanline is visited instead of all of the blocks.
+    int64_t area = 0;
+    for ( const Edge2D& e: edges )
+        area += e.area;
+
+    const bool spans = 2 * area < 3 * static_cast<int64_t>( maxX - minX + 1 ) * ( maxY - minY + 1 );
+
+    Plane<glm::vec4>  colorPlanes[N];
+    Plane<glm::ivec2> fixedPlanes[N];
+    bool              fixed = !samplerState.normalizedCoordinates && minTexCoord.x >= 0.0f && minTexCoord.y >= 0.0f;
+
+    for ( size_t i = 0; i < N; ++i )
     {
-        if ( x0 > x1 )
-        {
-            drawLineLow( x1, y1, x0, y0 );
-        }
-        else
-        {
-            drawLineLow( x0, y0, x1, y1 );
-        }
+        const Vertex2D& a = verts[indices[i * 3 + 0]];
+        const Vertex2D& b = verts[indices[i * 3 + 1]];
+        const Vertex2D& c = verts[indices[i * 3 + 2]];
+
+        colorPlanes[i] = edges[i].plane( toVec4( a.color ), toVec4( b.color ), toVec4( c.color ) );
+        fixed          = fixed && edges[i].fixedPlane( a.texCoord, b.texCoord, c.texCoord, maxX - minX + BlockSize, maxY - minY + BlockSize, fixedPlanes[i] );
+    }
+
+    if ( fixed )
+    {
+        Plane<Varyings<glm::ivec2>> planes[N];
+        for ( size_t i = 0; i < N; ++i )
+            planes[i] = makePlane( fixedPlanes[i], colorPlanes[i] );
+
+        shadeTextured( image, edges, planes, minX, minY, maxX, maxY, spans, toFixed( minTexCoord ), toFixed( maxTexCoord ), flatColor, texture, samplerState, blendMode );
     }
     else
     {
-        if ( y0 > y1 )
-        {
-            drawLineHigh( x1, y1, x0, y0 );
-        }
-        else
+        Plane<Varyings<glm::vec2>> planes[N];
+        for ( size_t i = 0; i < N; ++i )
         {
-            drawLineHigh( x0, y0, x1, y1 );
+            const Vertex2D& a = verts[indices[i * 3 + 0]];
+            const Vertex2D& b = verts[indices[i * 3 + 1]];
+            const Vertex2D& c = verts[indices[i * 3 + 2]];
+
+            planes[i] = makePlane( edges[i].plane( a.texCoord, b.texCoord, c.texCoord ), colorPlanes[i] );
         }
+
+        shadeTextured( image, edges, planes, minX, minY, maxX, maxY, spans, minTexCoord, maxTexCoord, flatColor, texture, samplerState, blendMode );
     }
 }
 
-// Source: Grok (Aug 27, 2025): What is the most efficient way to draw a circle in a 2D software rasterizer?
-void Rasterizer::drawCircle( int cx, int cy, int r ) const
+// Steps floor( ( numerator + delta * i ) / denominator ) for i = 0, 1, 2, ...
+// The value is stepped with an integer quotient and remainder (fixed-point with an exact fraction),
+// so it doesn't drift over long spans. This is used to map destination pixels to source texels for scaled blits.
+struct ScaleDDA
 {
-    Image* image = state.colorTarget;
+    int texel;          // Source texel of the current pixel.
+    int remainder;      // Fractional part of the texel ( remainder / denominator ).
+    int step;           // Whole texels per destination pixel.
+    int stepRemainder;  // Fractional texels per destination pixel ( stepRemainder / denominator ).
+    int denominator;
 
-    if ( !image )
-        return;
+    ScaleDDA( int64_t numerator, int64_t delta, int64_t _denominator )
+    {
+        if ( _denominator < 0 )
+        {
+            numerator    = -numerator;
+            delta        = -delta;
+            _denominator = -_denominator;
+        }
 
-    AABB aabb       = image->getAABB().clamped( AABB::fromViewport( state.viewport ) );
-    AABB circleAABB = AABB::fromCircle( Circle { { cx, cy }, static_cast<float>( r ) } );
+        const int64_t t = floor_div( numerator, _denominator );
+        const int64_t s = floor_div( delta, _denominator );
 
-    if ( !circleAABB.intersect( aabb ) )
-        return;
+        texel         = static_cast<int>( t );
+        remainder     = static_cast<int>( numerator - t * _denominator );
+        step          = static_cast<int>( s );
+        stepRemainder = static_cast<int>( delta - s * _denominator );
+        denominator   = static_cast<int>( _denominator );
+    }
 
-    switch ( state.fillMode )
-    {
-    case FillMode::WireFrame:
+    // Maps the destination pixels [p0, p1) (or [p1, p0) if the range is flipped) to the source texels [0, size),
+    // where pixel x maps to texel floor( ( x + 0.5 - p0 ) * size / ( p1 - p0 ) ).
+    static ScaleDDA pixelCenter( int x, int p0, int p1, int size )
     {
-        int x = 0;
-        int y = r;
-        int d = 3 - 2 * r;
+        return { ( 2 * static_cast<int64_t>( x - p0 ) + 1 ) * size, 2 * static_cast<int64_t>( size ), 2 * static_cast<int64_t>( p1 - p0 ) };
+    }
 
-        while ( x <= y )
+    // Step to the next destination pixel.
+    void next()
+    {
+        texel += step;
+        remainder += stepRemainder;
+        if ( remainder >= denominator )
         {
-            // Plot the 8 octants of the circle.
-            for ( auto offset: { glm::ivec2 { x, y }, glm::ivec2 { -x, y }, glm::ivec2 { x, -y }, glm::ivec2 { -x, -y }, glm::ivec2 { y, x }, glm::ivec2 { -y, x }, glm::ivec2 { y, -x }, glm::ivec2 { -y, x }, glm::ivec2 { -y, -x } } )
-            {
-                glm::ivec2 p { cx + offset.x, cy + offset.y };
-                image->plot<true>( p.x, p.y, state.color, state.blendMode );
-            }
-
-            ++x;
-            if ( d < 0 )
-            {
-                d += 4 * x + 6;
-            }
-            else
-            {
-                --y;
-                d += 4 * ( x - y ) + 10;
-            }
+            ++texel;
+            remainder -= denominator;
         }
     }
-    break;
-    case FillMode::Solid:
+
+private:
+    static int64_t floor_div( int64_t x, int64_t divisor )
     {
-        float radius = static_cast<float>( r );
-        for ( float y = -radius; y <= radius; ++y )
-        {
-            float x = radius * std::sqrt( 1.0f - ( y * y ) / ( radius * radius ) );
-            drawLine( cx - x, cy + y, cx + x, cy + y );
-        }
+        return x / divisor - ( x % divisor != 0 && ( ( x < 0 ) ^ ( divisor < 0 ) ) );
     }
-    break;
+};
+
+// Returns true if the matrix only scales (or flips) and translates.
+static bool isScaleTranslate( const glm::mat3& transform )
+{
+    constexpr float epsilon = 0.0001f;
+
+    return std::abs( transform[0][1] ) < epsilon && std::abs( transform[1][0] ) < epsilon && std::abs( transform[0][0] ) >= epsilon && std::abs( transform[1][1] ) >= epsilon;
+}
+
+// Returns true if a primitive with the (signed) area is front-facing.
+static bool isFrontFacing( const Rasterizer::State& state, int area )
+{
+    const bool ccw = area > 0;
+    return state.frontCounterClockwise ? ccw : !ccw;
+}
+
+// Returns true if a primitive is culled by the cull mode of the rasterizer state.
+static bool isCulled( const Rasterizer::State& state, bool isFront )
+{
+    switch ( state.cullMode )
+    {
+    case CullMode::Front:
+        return isFront;
+    case CullMode::Back:
+        return !isFront;
+    case CullMode::None:
+        break;
     }
+
+    return false;
 }
 
-void Rasterizer::drawTriangle( glm::ivec2 p0, glm::ivec2 p1, glm::ivec2 p2 ) const
+// Snap the vertex positions to pixels (the same way as the edge functions of a single triangle).
+static std::vector<glm::ivec2> snapPositions( std::span<const Vertex2D> vertices )
 {
-    Image* image = state.colorTarget;
+    std::vector<glm::ivec2> positions( vertices.size() );
+    std::ranges::transform( vertices, positions.begin(), []( const Vertex2D& v ) { return glm::ivec2 { v.position }; } );
+
+    return positions;
+}
+
+// Compute the AABB over all of the vertices of a batch.
+static AABB batchAABB( std::span<const Vertex2D> vertices )
+{
+    AABB aabb;
+    for ( const Vertex2D& v: vertices )
+        aabb.expand( glm::vec3 { v.position, 0.0f } );
+
+    return aabb;
+}
+
+// Compute the AABB over the bounds (minX, minY, maxX, maxY) of the primitives of a batch with the given indices.
+static AABB boundsAABB( std::span<const glm::ivec4> bounds, std::span<const uint32_t> indices )
+{
+    AABB aabb;
+    for ( uint32_t i: indices )
+    {
+        aabb.expand( glm::vec3 { bounds[i].x, bounds[i].y, 0 } );
+        aabb.expand( glm::vec3 { bounds[i].z, bounds[i].w, 0 } );
+    }
+
+    return aabb;
+}
+
+// Quads are culled and clipped in batches of QuadBatchSize quads (in SoA layout).
+constexpr int QuadBatchSize = 4;
+
+// A quad that is not culled and overlaps the clip rectangle.
+struct QuadSetup
+{
+    uint32_t quad;  // Index of the quad.
+    int      minX;  // Clipped bounds of the quad.
+    int      minY;
+    int      maxX;
+    int      maxY;
+};
+
+// A batch of quads in SoA layout: x[v][i] and y[v][i] are the position of vertex v of quad i.
+struct QuadBatch
+{
+    alignas( 16 ) float x[4][QuadBatchSize];
+    alignas( 16 ) float y[4][QuadBatchSize];
+};
+
+#if defined( SR_SIMD_SSE2 )
+// 32-bit integer multiply (_mm_mullo_epi32 requires SSE4.1).
+static __m128i simd_mullo_i32( __m128i a, __m128i b )
+{
+    #if defined( SR_SIMD_SSE4_1 )
+    return _mm_mullo_epi32( a, b );
+    #else
+    const __m128i even = _mm_mul_epu32( a, b );
+    const __m128i odd  = _mm_mul_epu32( _mm_srli_si128( a, 4 ), _mm_srli_si128( b, 4 ) );
+    return _mm_unpacklo_epi32( _mm_shuffle_epi32( even, _MM_SHUFFLE( 0, 0, 2, 0 ) ), _mm_shuffle_epi32( odd, _MM_SHUFFLE( 0, 0, 2, 0 ) ) );
+    #endif
+}
+
+// orient2D of 4 triangles at once.
+static __m128i simd_orient2D( __m128i ax, __m128i ay, __m128i bx, __m128i by, __m128i cx, __m128i cy )
+{
+    return _mm_sub_epi32( simd_mullo_i32( _mm_sub_epi32( bx, ax ), _mm_sub_epi32( cy, ay ) ), simd_mullo_i32( _mm_sub_epi32( by, ay ), _mm_sub_epi32( cx, ax ) ) );
+}
+#elif defined( SR_SIMD_NEON )
+// orient2D of 4 triangles at once.
+static int32x4_t simd_orient2D( int32x4_t ax, int32x4_t ay, int32x4_t bx, int32x4_t by, int32x4_t cx, int32x4_t cy )
+{
+    return vsubq_s32( vmulq_s32( vsubq_s32( bx, ax ), vsubq_s32( cy, ay ) ), vmulq_s32( vsubq_s32( by, ay ), vsubq_s32( cx, ax ) ) );
+}
+#endif
+
+// Cull and clip a batch of quads. This gives the same result as the per-quad checks in drawQuad.
+// Returns a mask of the quads that should be rasterized, and their clipped bounds in bounds[0...3][i] (minX, minY, maxX, maxY).
+static int setupQuadBatch( const QuadBatch& batch, const Rasterizer::State& state, const AABB& clip, int ( &bounds )[4][QuadBatchSize] )
+{
+#if defined( SR_SIMD_SSE2 )
+    __m128 x[4], y[4];
+    __m128i px[4], py[4];
+    for ( int v = 0; v < 4; ++v )
+    {
+        x[v]  = _mm_load_ps( batch.x[v] );
+        y[v]  = _mm_load_ps( batch.y[v] );
+        px[v] = _mm_cvttps_epi32( x[v] );  // Snap to pixels (the same as converting to glm::ivec2).
+        py[v] = _mm_cvttps_epi32( y[v] );
+    }
+
+    // Bounding boxes.
+    const __m128 minX = _mm_min_ps( _mm_min_ps( x[0], x[1] ), _mm_min_ps( x[2], x[3] ) );
+    const __m128 minY = _mm_min_ps( _mm_min_ps( y[0], y[1] ), _mm_min_ps( y[2], y[3] ) );
+    const __m128 maxX = _mm_max_ps( _mm_max_ps( x[0], x[1] ), _mm_max_ps( x[2], x[3] ) );
+    const __m128 maxY = _mm_max_ps( _mm_max_ps( y[0], y[1] ), _mm_max_ps( y[2], y[3] ) );
+
+    const __m128 clipMinX = _mm_set1_ps( clip.min.x );
+    const __m128 clipMinY = _mm_set1_ps( clip.min.y );
+    const __m128 clipMaxX = _mm_set1_ps( clip.max.x );
+    const __m128 clipMaxY = _mm_set1_ps( clip.max.y );
+
+    const __m128 overlap = _mm_and_ps( _mm_and_ps( _mm_cmple_ps( minX, clipMaxX ), _mm_cmpge_ps( maxX, clipMinX ) ), _mm_and_ps( _mm_cmple_ps( minY, clipMaxY ), _mm_cmpge_ps( maxY, clipMinY ) ) );
+
+    _mm_store_si128( reinterpret_cast<__m128i*>( bounds[0] ), _mm_cvttps_epi32( _mm_max_ps( minX, clipMinX ) ) );
+    _mm_store_si128( reinterpret_cast<__m128i*>( bounds[1] ), _mm_cvttps_epi32( _mm_max_ps( minY, clipMinY ) ) );
+    _mm_store_si128( reinterpret_cast<__m128i*>( bounds[2] ), _mm_cvttps_epi32( _mm_min_ps( maxX, clipMaxX ) ) );
+    _mm_store_si128( reinterpret_cast<__m128i*>( bounds[3] ), _mm_cvttps_epi32( _mm_min_ps( maxY, clipMaxY ) ) );
+
+    // Culling of the triangles (v0, v1, v2) and (v2, v3, v0).
+    const __m128i zero  = _mm_setzero_si128();
+    const __m128i area1 = simd_orient2D( px[0], py[0], px[1], py[1], px[2], py[2] );
+    const __m128i area2 = simd_orient2D( px[2], py[2], px[3], py[3], px[0], py[0] );
+
+    const __m128i degenerate = _mm_and_si128( _mm_cmpeq_epi32( area1, zero ), _mm_cmpeq_epi32( area2, zero ) );
+    const __m128i ccw1       = _mm_cmpgt_epi32( area1, zero );
+    const __m128i ccw2       = _mm_cmpgt_epi32( area2, zero );
+    const __m128i front      = state.frontCounterClockwise ? _mm_and_si128( ccw1, ccw2 ) : _mm_andnot_si128( _mm_or_si128( ccw1, ccw2 ), _mm_set1_epi32( -1 ) );
+
+    const int frontMask = _mm_movemask_ps( _mm_castsi128_ps( front ) );
+    const int visible   = _mm_movemask_ps( overlap ) & ~_mm_movemask_ps( _mm_castsi128_ps( degenerate ) );
+#elif defined( SR_SIMD_NEON )
+    float32x4_t x[4], y[4];
+    int32x4_t   px[4], py[4];
+    for ( int v = 0; v < 4; ++v )
+    {
+        x[v]  = vld1q_f32( batch.x[v] );
+        y[v]  = vld1q_f32( batch.y[v] );
+        px[v] = vcvtq_s32_f32( x[v] );  // Snap to pixels (the same as converting to glm::ivec2).
+        py[v] = vcvtq_s32_f32( y[v] );
+    }
+
+    // Bounding boxes.
+    const float32x4_t minX = vminq_f32( vminq_f32( x[0], x[1] ), vminq_f32( x[2], x[3] ) );
+    const float32x4_t minY = vminq_f32( vminq_f32( y[0], y[1] ), vminq_f32( y[2], y[3] ) );
+    const float32x4_t maxX = vmaxq_f32( vmaxq_f32( x[0], x[1] ), vmaxq_f32( x[2], x[3] ) );
+    const float32x4_t maxY = vmaxq_f32( vmaxq_f32( y[0], y[1] ), vmaxq_f32( y[2], y[3] ) );
+
+    const float32x4_t clipMinX = vdupq_n_f32( clip.min.x );
+    const float32x4_t clipMinY = vdupq_n_f32( clip.min.y );
+    const float32x4_t clipMaxX = vdupq_n_f32( clip.max.x );
+    const float32x4_t clipMaxY = vdupq_n_f32( clip.max.y );
+
+    const uint32x4_t overlap = vandq_u32( vandq_u32( vcleq_f32( minX, clipMaxX ), vcgeq_f32( maxX, clipMinX ) ), vandq_u32( vcleq_f32( minY, clipMaxY ), vcgeq_f32( maxY, clipMinY ) ) );
+
+    vst1q_s32( bounds[0], vcvtq_s32_f32( vmaxq_f32( minX, clipMinX ) ) );
+    vst1q_s32( bounds[1], vcvtq_s32_f32( vmaxq_f32( minY, clipMinY ) ) );
+    vst1q_s32( bounds[2], vcvtq_s32_f32( vminq_f32( maxX, clipMaxX ) ) );
+    vst1q_s32( bounds[3], vcvtq_s32_f32( vminq_f32( maxY, clipMaxY ) ) );
+
+    // Culling of the triangles (v0, v1, v2) and (v2, v3, v0).
+    const int32x4_t zero  = vdupq_n_s32( 0 );
+    const int32x4_t area1 = simd_orient2D( px[0], py[0], px[1], py[1], px[2], py[2] );
+    const int32x4_t area2 = simd_orient2D( px[2], py[2], px[3], py[3], px[0], py[0] );
+
+    const uint32x4_t degenerate = vandq_u32( vceqq_s32( area1, zero ), vceqq_s32( area2, zero ) );
+    const uint32x4_t ccw1       = vcgtq_s32( area1, zero );
+    const uint32x4_t ccw2       = vcgtq_s32( area2, zero );
+    const uint32x4_t front      = state.frontCounterClockwise ? vandq_u32( ccw1, ccw2 ) : vmvnq_u32( vorrq_u32( ccw1, ccw2 ) );
+    const uint32x4_t visibleV   = vbicq_u32( overlap, degenerate );
+
+    uint32_t frontLanes[QuadBatchSize], visibleLanes[QuadBatchSize];
+    vst1q_u32( frontLanes, front );
+    vst1q_u32( visibleLanes, visibleV );
+
+    int frontMask = 0, visible = 0;
+    for ( int i = 0; i < QuadBatchSize; ++i )
+    {
+        frontMask |= ( frontLanes[i] != 0 ) << i;
+        visible |= ( visibleLanes[i] != 0 ) << i;
+    }
+#else
+    int frontMask = 0, visible = 0;
+    for ( int i = 0; i < QuadBatchSize; ++i )
+    {
+        glm::ivec2 p[4];
+        AABB       quadAABB;
+        for ( int v = 0; v < 4; ++v )
+        {
+            p[v] = glm::ivec2 { batch.x[v][i], batch.y[v][i] };
+            quadAABB.expand( glm::vec3 { batch.x[v][i], batch.y[v][i], 0.0f } );
+        }
+
+        const int area1 = orient2D( p[0], p[1], p[2] );
+        const int area2 = orient2D( p[2], p[3], p[0] );
+
+        const AABB aabb = quadAABB.clamped( clip );
+
+        bounds[0][i] = static_cast<int>( aabb.min.x );
+        bounds[1][i] = static_cast<int>( aabb.min.y );
+        bounds[2][i] = static_cast<int>( aabb.max.x );
+        bounds[3][i] = static_cast<int>( aabb.max.y );
+
+        frontMask |= ( isFrontFacing( state, area1 ) && isFrontFacing( state, area2 ) ) << i;
+        visible |= ( quadAABB.intersect( clip ) && !( area1 == 0 && area2 == 0 ) ) << i;
+    }
+#endif
+
+    switch ( state.cullMode )
+    {
+    case CullMode::Front:
+        return visible & ~frontMask;
+    case CullMode::Back:
+        return visible & frontMask;
+    case CullMode::None:
+        break;
+    }
+
+    return visible;
+}
+
+// Cull and clip count quads, where quad i has the vertices vertices[index( i * 4 + 0...3 )].
+// Returns the quads that should be rasterized.
+template<typename Index>
+static std::vector<QuadSetup> setupQuads( std::span<const Vertex2D> vertices, size_t count, Index&& index, const Rasterizer::State& state, const AABB& clip )
+{
+    std::vector<QuadSetup> quads;
+    quads.reserve( count );
+
+    for ( size_t first = 0; first < count; first += QuadBatchSize )
+    {
+        const int n = static_cast<int>( std::min<size_t>( QuadBatchSize, count - first ) );
+
+        // Gather the vertices of the batch. Unused lanes repeat the first quad of the batch.
+        QuadBatch batch;
+        for ( int i = 0; i < QuadBatchSize; ++i )
+        {
+            const size_t quad = first + ( i < n ? i : 0 );
+            for ( int v = 0; v < 4; ++v )
+            {
+                const glm::vec2& position = vertices[index( quad * 4 + v )].position;
+
+                batch.x[v][i] = position.x;
+                batch.y[v][i] = position.y;
+            }
+        }
+
+        alignas( 16 ) int bounds[4][QuadBatchSize];
+        int               mask = setupQuadBatch( batch, state, clip, bounds ) & ( ( 1 << n ) - 1 );
+
+        // Compact the quads that survived.
+        while ( mask )
+        {
+            const int i = count_trailing_zeros( mask );
+            mask &= mask - 1;
+
+            quads.push_back( { static_cast<uint32_t>( first + i ), bounds[0][i], bounds[1][i], bounds[2][i], bounds[3][i] } );
+        }
+    }
+
+    return quads;
+}
+
+// Rasterize a quad that was set up with setupQuads.
+static void rasterizeQuad( Image& image, std::span<const Vertex2D> vertices, const std::vector<glm::ivec2>& positions, const uint32_t ( &quad )[4], const QuadSetup& setup, const Image& texture, const SamplerState& samplerState, const BlendMode& blendMode )
+{
+    const glm::ivec2 p { setup.minX, setup.minY };
+
+    const Edge2D e[] {
+        Edge2D { positions[quad[0]], positions[quad[1]], positions[quad[2]], p },
+        Edge2D { positions[quad[2]], positions[quad[3]], positions[quad[0]], p }
+    };
+
+    const uint32_t triangles[] = {
+        quad[0], quad[1], quad[2],
+        quad[2], quad[3], quad[0]
+    };
+
+    rasterizeTextured( image, e, vertices.data(), triangles, setup.minX, setup.minY, setup.maxX, setup.maxY, texture, samplerState, blendMode );
+}
+
+// A batch of circles, together with the span tables of the radii of the circles.
+struct CircleBatch
+{
+    CircleBatch( std::span<const Circle> _circles, std::span<const Color> _colors )
+    : colors { _colors.begin(), _colors.end() }
+    {
+        circles.reserve( _circles.size() );
+        for ( const Circle& c: _circles )
+        {
+            const glm::ivec3 circle { static_cast<int>( c.center.x ), static_cast<int>( c.center.y ), static_cast<int>( c.radius ) };
+            circles.push_back( circle );
+
+            if ( circle.z < 0 )
+                continue;
+
+            if ( circle.z >= static_cast<int>( spans.size() ) )
+                spans.resize( circle.z + 1 );
+
+            // The half-width of each row of the circle (from the center row to the last row).
+            std::vector<int>& halfWidths = spans[circle.z];
+            if ( halfWidths.empty() )
+            {
+                halfWidths.resize( circle.z + 1 );
+                forEachEllipseRow( circle.z, circle.z, [&halfWidths]( int y, int halfWidth ) { halfWidths[y] = halfWidth; } );
+            }
+        }
+    }
+
+    std::vector<glm::ivec3>       circles;  // Center (x, y) and radius (z) of each circle (in pixels).
+    std::vector<Color>            colors;   // The color of each circle (if empty, the color of the rasterizer state is used).
+    std::vector<std::vector<int>> spans;    // The half-widths of the rows of a circle with radius r: spans[r][row].
+};
+
+// Draw the circles of a batch with the indices, clipped to clip.
+static void rasterizeCircles( const Rasterizer::State& state, const AABB& clip, const CircleBatch& batch, std::span<const uint32_t> indices )
+{
+    Image& image = *state.colorTarget;
+
+    const int minX = static_cast<int>( clip.min.x );
+    const int minY = static_cast<int>( clip.min.y );
+    const int maxX = static_cast<int>( clip.max.x );
+    const int maxY = static_cast<int>( clip.max.y );
+
+    dispatchBlend( state.blendMode, [&]( auto pipeline ) {
+        for ( uint32_t i: indices )
+        {
+            const int               cx         = batch.circles[i].x;
+            const int               cy         = batch.circles[i].y;
+            const int               r          = batch.circles[i].z;
+            const std::vector<int>& halfWidths = batch.spans[r];
+            const Color             color      = batch.colors.empty() ? state.color : batch.colors[i];
+
+            switch ( state.fillMode )
+            {
+            case FillMode::WireFrame:
+            {
+                // Plot a pixel in each of the 4 quadrants of the circle (without plotting the pixels on the axes twice).
+                auto plot = [&]( int x, int y ) {
+                    for ( int sx: { 1, -1 } )
+                    {
+                        for ( int sy: { 1, -1 } )
+                        {
+                            if ( ( sx < 0 && x == 0 ) || ( sy < 0 && y == 0 ) )
+                                continue;
+
+                            const int px = cx + sx * x;
+                            const int py = cy + sy * y;
+                            if ( px >= minX && px <= maxX && py >= minY && py <= maxY )
+                                image.plot<false, true, pipeline, false>( px, py, color, state.blendMode );
+                        }
+                    }
+                };
+
+                // The outline of a row are the pixels that are not covered by the next row (away from the center).
+                for ( int y = 0; y <= r; ++y )
+                {
+                    const int next = y < r ? halfWidths[y + 1] : -1;
+                    for ( int x = std::min( next + 1, halfWidths[y] ); x <= halfWidths[y]; ++x )
+                        plot( x, y );
+                }
+            }
+            break;
+            case FillMode::Solid:
+            {
+                // Only the rows of the circle that are inside of the clip rectangle are visited.
+                const int first = std::max( -r, minY - cy );
+                const int last  = std::min( r, maxY - cy );
+
+                for ( int y = first; y <= last; ++y )
+                {
+                    const int halfWidth = halfWidths[std::abs( y )];
+                    const int x0        = std::max( cx - halfWidth, minX );
+                    const int x1        = std::min( cx + halfWidth, maxX );
+
+                    if ( x0 <= x1 )
+                        fillSpan( image, cy + y, x0, x1, color, state.blendMode );
+                }
+            }
+            break;
+            }
+        }
+    } );
+}
+
+// A batch of points.
+struct PointBatch
+{
+    std::vector<glm::ivec2> points;  // The position of each point (in pixels).
+    std::vector<Color>      colors;  // The color of each point (if empty, the color of the rasterizer state is used).
+};
+
+// Draw the points of a batch with the indices, clipped to clip.
+static void rasterizePoints( const Rasterizer::State& state, const AABB& clip, const PointBatch& batch, std::span<const uint32_t> indices )
+{
+    Image& image = *state.colorTarget;
+
+    dispatchBlend( state.blendMode, [&]( auto pipeline ) {
+        for ( uint32_t i: indices )
+        {
+            const glm::ivec2& p = batch.points[i];
+            if ( clip.contains( p ) )
+                image.plot<false, true, pipeline, false>( p.x, p.y, batch.colors.empty() ? state.color : batch.colors[i], state.blendMode );
+        }
+    } );
+}
+
+// Compute the outcode of a pixel relative to the rectangle [minX, maxX] x [minY, maxY].
+static OutCode computeOutCode( int x, int y, int minX, int minY, int maxX, int maxY )
+{
+    OutCode code = OutCode::Inside;
+
+    if ( x < minX )
+        code |= OutCode::Left;
+    else if ( x > maxX )
+        code |= OutCode::Right;
+
+    if ( y < minY )
+        code |= OutCode::Bottom;
+    else if ( y > maxY )
+        code |= OutCode::Top;
+
+    return code;
+}
+
+// Step through the pixels of a line with Bresenham's algorithm, where the line is stepped along the major axis
+// from the smaller to the larger coordinate (so a line covers the same pixels in both directions).
+// The pixels are written through a pointer into the image:
+// majorStep is the pointer offset of a step along the major axis, and minorStep of a step along the minor axis.
+// Only the pixels inside of the clip rectangle are written. The first and last steps inside of the clip rectangle are
+// computed directly, so a tile of the binner only steps through its own part of the line (with the same pixels as
+// stepping through the entire line).
+template<BlendPipeline Pipeline>
+static void rasterizeLine( Image& image, int x0, int y0, int x1, int y1, const AABB& clip, const Color& color, const BlendMode& blendMode )
+{
+    const int  width = static_cast<int>( image.getWidth() );
+    const bool low   = std::abs( y1 - y0 ) < std::abs( x1 - x0 );
+
+    if ( low ? x0 > x1 : y0 > y1 )
+    {
+        std::swap( x0, x1 );
+        std::swap( y0, y1 );
+    }
+
+    const int major     = low ? x1 - x0 : y1 - y0;
+    const int minorSign = ( low ? y1 - y0 : x1 - x0 ) < 0 ? -1 : 1;
+    const int minor     = std::abs( low ? y1 - y0 : x1 - x0 );
+
+    const ptrdiff_t majorStep = low ? 1 : width;
+    const ptrdiff_t minorStep = low ? minorSign * width : minorSign;
+
+    // The number of steps along the minor axis after i steps along the major axis.
+    // Step i moves along the minor axis if 2 * minor * ( i + 1 ) - major > 2 * major * m( i ),
+    // so m( i ) = ceil( ( 2 * minor * i - major ) / ( 2 * major ) ) (and 0 before the first step along the minor axis).
+    auto minorSteps = [minor, major]( int i ) -> int64_t {
+        const int64_t t = 2 * static_cast<int64_t>( minor ) * i - major;
+        return t <= 0 ? 0 : ( t + 2 * static_cast<int64_t>( major ) - 1 ) / ( 2 * static_cast<int64_t>( major ) );
+    };
+
+    // The clip rectangle relative to the start of the line, along the major and minor axes.
+    const int majorMin = static_cast<int>( low ? clip.min.x : clip.min.y ) - ( low ? x0 : y0 );
+    const int majorMax = static_cast<int>( low ? clip.max.x : clip.max.y ) - ( low ? x0 : y0 );
+    const int minorMin = static_cast<int>( low ? clip.min.y : clip.min.x ) - ( low ? y0 : x0 );
+    const int minorMax = static_cast<int>( low ? clip.max.y : clip.max.x ) - ( low ? y0 : x0 );
+
+    // The range of the number of steps along the minor axis that are inside of the clip rectangle.
+    const int64_t minStepsInside = minorSign > 0 ? minorMin : -minorMax;
+    const int64_t maxStepsInside = minorSign > 0 ? minorMax : -minorMin;
+
+    // The steps along the major axis that are inside of the clip rectangle.
+    // The number of steps along the minor axis increases with each step, so the steps inside of the clip rectangle are contiguous.
+    int first = std::max( 0, majorMin );
+    int last  = std::min( major, majorMax );
+
+    if ( first > last )
+        return;
+
+    const auto majorSteps = std::views::iota( first, last + 1 );
+    const auto begin      = std::ranges::partition_point( majorSteps, [&]( int i ) { return minorSteps( i ) < minStepsInside; } );
+    const auto end        = std::ranges::partition_point( majorSteps, [&]( int i ) { return minorSteps( i ) <= maxStepsInside; } );
+
+    if ( begin >= end )
+        return;
+
+    first = *begin;
+    last  = first + static_cast<int>( end - begin ) - 1;
+
+    // Start at the first step inside of the clip rectangle, with the error term of that step.
+    const int m = static_cast<int>( minorSteps( first ) );
+    const int x = low ? x0 + first : x0 + minorSign * m;
+    const int y = low ? y0 + minorSign * m : y0 + first;
+
+    Color* dst = image.data() + static_cast<ptrdiff_t>( y ) * width + x;
+    int    D   = static_cast<int>( 2 * static_cast<int64_t>( minor ) * ( first + 1 ) - major - 2 * static_cast<int64_t>( major ) * m );
+
+    for ( int i = first;; ++i )
+    {
+        *dst = blendMode.Blend<Pipeline>( color, *dst );
+
+        // Don't step past the last pixel (the pointer could end up outside of the image).
+        if ( i == last )
+            break;
+
+        dst += majorStep;
+
+        if ( D > 0 )
+        {
+            dst += minorStep;
+            D -= 2 * major;
+        }
+        D += 2 * minor;
+    }
+}
+
+// Draw the lines ( x0, y0, x1, y1 ) with the indices, clipped to clip.
+// The lines must already be clipped to the color target.
+static void rasterizeLines( const Rasterizer::State& state, const AABB& clip, const std::vector<glm::ivec4>& lines, std::span<const uint32_t> indices )
+{
+    Image& image = *state.colorTarget;
+
+    dispatchBlend( state.blendMode, [&]( auto pipeline ) {
+        for ( uint32_t i: indices )
+        {
+            const glm::ivec4& line = lines[i];
+            rasterizeLine<pipeline>( image, line.x, line.y, line.z, line.w, clip, state.color, state.blendMode );
+        }
+    } );
+}
+
+// An AABB that covers the entire color target.
+// Used for draw calls that don't have (or ignore) screen-space bounds.
+static AABB unboundedAABB()
+{
+    return AABB::fromMinMax( glm::vec3 { std::numeric_limits<float>::lowest() }, glm::vec3 { std::numeric_limits<float>::max() } );
+}
+
+// Draw calls that are recorded while binning.
+struct Rasterizer::Binner
+{
+    struct Command
+    {
+        State                                    state;  // A copy of the rasterizer state when the draw call was recorded.
+        std::function<void( const Rasterizer& )> draw;   // Replays the draw call on the tile rasterizer.
+    };
+
+    struct Tile
+    {
+        AABB                  rect;      // The region of the color target covered by this tile.
+        std::vector<uint32_t> commands;  // Indices of the commands that overlap this tile (in submission order).
+    };
+
+    // The draw calls that are binned for a color target, and the tile grid that they are sorted into.
+    // The batch is taken out of the binner when it is flushed, so the tiles are rasterized without holding the mutex.
+    struct Batch
+    {
+        int width   = 0;
+        int height  = 0;
+        int columns = 0;
+        int rows    = 0;
+
+        Image*               target = nullptr;  // All binned commands draw to this color target.
+        std::vector<Command> commands;
+        std::vector<Tile>    tiles;
+        std::vector<int>     activeTiles;  // Tiles that have at least one command.
+    };
+
+    explicit Binner( int tileSize )
+    : tileSize { std::max( tileSize, 8 ) }
+    {}
+
+    // Build the tile grid for the color target.
+    void setTarget( Image* image )
+    {
+        batch.target = image;
+
+        if ( image->getWidth() == batch.width && image->getHeight() == batch.height )
+            return;
+
+        batch.width   = image->getWidth();
+        batch.height  = image->getHeight();
+        batch.columns = ( batch.width + tileSize - 1 ) / tileSize;
+        batch.rows    = ( batch.height + tileSize - 1 ) / tileSize;
+
+        batch.tiles.resize( static_cast<size_t>( batch.columns * batch.rows ) );
+
+        for ( int i = 0; i < batch.rows; ++i )
+        {
+            for ( int j = 0; j < batch.columns; ++j )
+            {
+                const int x = j * tileSize;
+                const int y = i * tileSize;
+
+                batch.tiles[i * batch.columns + j].rect = AABB::fromMinMax( { x, y, 0 }, { std::min( x + tileSize, batch.width ) - 1, std::min( y + tileSize, batch.height ) - 1, 0 } );
+            }
+        }
+    }
+
+    int        tileSize;
+    Batch      batch;
+    std::mutex mutex;  // Guards the batch against concurrent submission (the order of concurrent draw calls is unspecified).
+};
+
+Rasterizer::Rasterizer()  = default;
+Rasterizer::~Rasterizer() = default;
+
+Rasterizer::Rasterizer( const Rasterizer& )            = default;
+Rasterizer& Rasterizer::operator=( const Rasterizer& ) = default;
+
+Rasterizer::Rasterizer( Rasterizer&& ) noexcept            = default;
+Rasterizer& Rasterizer::operator=( Rasterizer&& ) noexcept = default;
+
+void Rasterizer::beginBinning( int tileSize )
+{
+    if ( m_Binner && m_Binner->tileSize == tileSize )
+        return;
+
+    flush();
+    m_Binner = std::make_shared<Binner>( tileSize );
+}
+
+void Rasterizer::endBinning()
+{
+    flush();
+    m_Binner.reset();
+}
+
+void Rasterizer::flush() const
+{
+    if ( !m_Binner )
+        return;
+
+    Binner&       binner = *m_Binner;
+    Binner::Batch batch;
+
+    // Take the binned draw calls, so the mutex is not held while the tiles are rasterized.
+    {
+        std::lock_guard<std::mutex> lock( binner.mutex );
+
+        if ( binner.batch.commands.empty() )
+            return;
+
+        batch = std::exchange( binner.batch, {} );
+    }
+
+    // Each tile writes to a disjoint region of the color target, so tiles can be rasterized in parallel.
+    // Within a tile, commands are replayed in submission order to preserve the blend order.
+    parallelForEach( batch.activeTiles, [&batch]( int tileIndex ) {
+        Binner::Tile& tile = batch.tiles[tileIndex];
+
+        Rasterizer rasterizer;
+        rasterizer.m_Scissor = tile.rect;
+
+        // Each draw call resolves the lazy clear of the region of the tile that it writes to (and marks it as dirty),
+        // so the parts of the tile that are overwritten by opaque draw calls are not cleared first.
+        for ( uint32_t commandIndex: tile.commands )
+        {
+            const Binner::Command& command = batch.commands[commandIndex];
+
+            rasterizer.state = command.state;
+            command.draw( rasterizer );
+        }
+
+        tile.commands.clear();
+    } );
+
+    batch.commands.clear();
+    batch.activeTiles.clear();
+    batch.target = nullptr;
+
+    // Give the (now empty) batch back to the binner, so the tile grid and the capacity of the vectors are reused.
+    // If draw calls were binned while the tiles were rasterized, the binner already has a new batch.
+    std::lock_guard<std::mutex> lock( binner.mutex );
+
+    if ( binner.batch.commands.empty() )
+        binner.batch = std::move( batch );
+}
+
+void Rasterizer::beginRecording( CommandList& commandList )
+{
+    m_CommandList = &commandList;
+}
+
+void Rasterizer::endRecording()
+{
+    m_CommandList = nullptr;
+}
+
+void Rasterizer::execute( const CommandList& commandList ) const
+{
+    // Appending the commands to the command list that is being replayed would invalidate the iterators.
+    assert( &commandList != m_CommandList );
+    if ( &commandList == m_CommandList )
+        return;
+
+    Rasterizer rasterizer;
+    rasterizer.m_Scissor = m_Scissor;
+
+    for ( const CommandList::Command& command: commandList.m_Commands )
+    {
+        State commandState = command.state;
+
+        if ( state.colorTarget )
+            commandState.colorTarget = state.colorTarget;
+
+        // Cull draw calls that do not overlap the color target.
+        if ( commandState.colorTarget && !command.bounds.intersect( commandState.colorTarget->getAABB() ) )
+            continue;
+
+        if ( m_CommandList )
+        {
+            m_CommandList->m_Commands.emplace_back( commandState, command.bounds, command.draw );
+            continue;
+        }
+
+        if ( submit( commandState, command.bounds, [&draw = command.draw]( const Rasterizer& tileRasterizer ) { draw( tileRasterizer ); } ) )
+            continue;
+
+        rasterizer.state = commandState;
+        command.draw( rasterizer );
+    }
+}
+
+bool Rasterizer::bin( const math::AABB& bounds, std::function<void( const Rasterizer& )> command, const std::optional<math::AABB>& overwritten ) const
+{
+    if ( m_CommandList )
+    {
+        m_CommandList->m_Commands.emplace_back( state, bounds, std::move( command ) );
+        return true;
+    }
+
+    if ( submit( state, bounds, std::move( command ) ) )
+        return true;
+
+    // The draw call is executed immediately, so the tiles of the color target that it overlaps
+    // must be cleared first if the color target was cleared lazily (see Image::fastClear), and marked as dirty.
+    if ( state.colorTarget )
+        beginWrite( *state.colorTarget, getClipAABB().clamped( bounds ), overwritten );
+
+    return false;
+}
+
+bool Rasterizer::submit( const State& commandState, const math::AABB& bounds, std::function<void( const Rasterizer& )> command ) const
+{
+    if ( !m_Binner )
+        return false;
+
+    Image* image = commandState.colorTarget;
+
+    if ( !image )
+        return true;
+
+    Binner&                      binner = *m_Binner;
+    std::unique_lock<std::mutex> lock( binner.mutex );
+
+    // Only one color target can be binned at a time. If the color target changes, the pending draw calls are
+    // flushed first so that images that were rendered to can be used as a texture in the following draw calls.
+    // The mutex is released while flushing, since the tiles are rasterized by the worker threads.
+    while ( binner.batch.target != image )
+    {
+        if ( binner.batch.commands.empty() )
+        {
+            binner.setTarget( image );
+            break;
+        }
+
+        lock.unlock();
+        flush();
+        lock.lock();
+    }
+
+    AABB aabb = image->getAABB();
+
+    if ( !bounds.intersect( aabb ) )
+        return true;
+
+    aabb.clamp( bounds );
+
+    const int minX = static_cast<int>( aabb.min.x ) / binner.tileSize;
+    const int minY = static_cast<int>( aabb.min.y ) / binner.tileSize;
+    const int maxX = static_cast<int>( aabb.max.x ) / binner.tileSize;
+    const int maxY = static_cast<int>( aabb.max.y ) / binner.tileSize;
+
+    Binner::Batch& batch = binner.batch;
+
+    const auto commandIndex = static_cast<uint32_t>( batch.commands.size() );
+    batch.commands.emplace_back( commandState, std::move( command ) );
+
+    for ( int i = minY; i <= maxY; ++i )
+    {
+        for ( int j = minX; j <= maxX; ++j )
+        {
+            const int     tileIndex = i * batch.columns + j;
+            Binner::Tile& tile      = batch.tiles[tileIndex];
+
+            if ( tile.commands.empty() )
+                batch.activeTiles.push_back( tileIndex );
+
+            tile.commands.push_back( commandIndex );
+        }
+    }
+
+    return true;
+}
+
+AABB Rasterizer::getClipAABB() const
+{
+    AABB aabb = state.colorTarget->getAABB().clamped( AABB::fromViewport( state.viewport ) );
+
+    if ( m_Scissor )
+        aabb.clamp( *m_Scissor );
+
+    return aabb;
+}
+
+CoverageMask* Rasterizer::getCoverageMask( const BlendMode& blendMode ) const
+{
+    CoverageMask* coverageMask = state.coverageMask;
+
+    // Translucent pixels are blended on top of the pixels that are already covered, so they are not tested against the coverage mask.
+    const BlendPipeline pipeline = blendMode.getPipeline();
+    if ( pipeline != BlendPipeline::Disable && pipeline != BlendPipeline::AlphaDiscard )
+        return nullptr;
+
+    if ( coverageMask && state.colorTarget && std::cmp_equal( coverageMask->getWidth(), state.colorTarget->getWidth() ) && std::cmp_equal( coverageMask->getHeight(), state.colorTarget->getHeight() ) )
+        return coverageMask;
+
+    return nullptr;
+}
+
+void Rasterizer::drawText( std::shared_ptr<const Font> font, std::string_view str, int x, int y ) const
+{
+    if ( !font )
+        return;
+
+    // The glyphs are laid out (and missing glyphs are added to the atlas) when the draw call is issued,
+    // so the tiles only read from the atlas when the draw call is replayed.
+    std::shared_ptr<GlyphAtlas>   atlas = font->getGlyphAtlas();
+    std::vector<GlyphAtlas::Quad> quads = atlas->layout( str, x, y );
+
+    if ( quads.empty() )
+        return;
+
+    AABB bounds;
+    for ( const GlyphAtlas::Quad& quad: quads )
+    {
+        bounds.expand( glm::vec3 { quad.position, 0 } );
+        bounds.expand( glm::vec3 { quad.position + glm::ivec2 { quad.rect.width, quad.rect.height } - 1, 0 } );
+    }
+
+    // The glyph quads are tinted with the text color (or the outline color). The glyphs have an alpha channel,
+    // so they are alpha blended unless another blend mode is enabled (the same as drawing a Text).
+    const BlendMode blendMode = state.blendMode.blendEnable ? state.blendMode : BlendMode::AlphaBlend;
+
+    // The draw call keeps the glyph atlas alive, in case the font changes before it is replayed.
+    auto draw = [atlas = std::move( atlas ), quads = std::move( quads ), blendMode]( const Rasterizer& rasterizer ) {
+        for ( const GlyphAtlas::Quad& quad: quads )
+        {
+            const glm::ivec2 p0 = quad.position;
+            const glm::ivec2 p1 = quad.position + glm::ivec2 { quad.rect.width, quad.rect.height };
+            const glm::ivec2 t0 { quad.rect.left, quad.rect.top };
+            const glm::ivec2 t1 = t0 + glm::ivec2 { quad.rect.width, quad.rect.height };
+            const Color      color = quad.outline ? rasterizer.state.outlineColor : rasterizer.state.color;
+
+            rasterizer.drawScaled( *quad.page, p0, p1, t0, t1, color, blendMode );
+        }
+    };
+
+    if ( bin( bounds, draw ) )
+        return;
+
+    draw( *this );
+}
+
+void Rasterizer::drawText( std::string_view text, int x, int y ) const
+{
+    drawText( ResourceManager::loadFont(), text, x, y );
+}
+
+void Rasterizer::drawText( const Text& text, int x, int y ) const
+{
+    // The cached image of the text is updated when the draw call is issued, so the tiles only read from the image when the draw call is replayed.
+    std::shared_ptr<const Image> image = text.getImage();
+
+    if ( !image )
+        return;
+
+    const int        padding = text.getImagePadding();
+    const glm::ivec2 p0 { x - padding, y - padding };
+    const glm::ivec2 size { image->getWidth(), image->getHeight() };
+
+    // The text image has an alpha channel, so it is alpha blended unless another blend mode is enabled.
+    const BlendMode blendMode = state.blendMode.blendEnable ? state.blendMode : BlendMode::AlphaBlend;
+
+    // The draw call keeps the image alive, in case the text changes before it is replayed.
+    auto draw = [image = std::move( image ), p0, size, blendMode]( const Rasterizer& rasterizer ) {
+        rasterizer.drawScaled( *image, p0, p0 + size, { 0, 0 }, size, Color::White, blendMode );
+    };
+
+    if ( bin( AABB::fromMinMax( { p0, 0 }, { p0 + size - 1, 0 } ), draw ) )
+        return;
+
+    draw( *this );
+}
+
+void Rasterizer::clear( std::optional<Color> color ) const
+{
+    Image*      image      = state.colorTarget;
+    const Color clearColor = color.value_or( state.color );
+
+    // Clearing ignores the viewport and covers the entire color target.
+    // In immediate mode, the color target is cleared directly (which also discards the pending tiles of a lazy clear).
+    if ( !m_CommandList && !m_Binner && !m_Scissor )
+    {
+        if ( image )
+            image->clear( clearColor );
+
+        return;
+    }
+
+    if ( bin( unboundedAABB(), [clearColor]( const Rasterizer& rasterizer ) { rasterizer.clear( clearColor ); }, m_Scissor ) )
+        return;
+
+    if ( !image )
+        return;
+
+    if ( m_Scissor )
+    {
+        // Only clear the tile that is being rasterized (which ignores the viewport).
+        beginWrite( *image, *m_Scissor, m_Scissor );
+
+        const int minX  = static_cast<int>( m_Scissor->min.x );
+        const int minY  = static_cast<int>( m_Scissor->min.y );
+        const int maxX  = static_cast<int>( m_Scissor->max.x );
+        const int maxY  = static_cast<int>( m_Scissor->max.y );
+        const int width = image->getWidth();
+
+        for ( int y = minY; y <= maxY; ++y )
+        {
+            std::fill_n( image->data() + y * width + minX, maxX - minX + 1, clearColor );
+        }
+    }
+    else
+    {
+        image->clear( clearColor );
+    }
+}
+
+void Rasterizer::fastClear( std::optional<Color> color ) const
+{
+    Image*      image      = state.colorTarget;
+    const Color clearColor = color.value_or( state.color );
+
+    // Command lists and tiles are cleared normally.
+    if ( m_CommandList || m_Scissor )
+    {
+        clear( clearColor );
+        return;
+    }
+
+    if ( !image )
+        return;
+
+    // Binned draw calls must be rasterized before the tiles are marked as cleared.
+    flush();
+
+    image->fastClear( clearColor );
+}
+
+void Rasterizer::drawLine( int x0, int y0, int x1, int y1 ) const
+{
+    Image* image = state.colorTarget;
+
+    if ( bin( AABB { glm::vec2 { x0, y0 }, glm::vec2 { x1, y1 } }, [=]( const Rasterizer& rasterizer ) { rasterizer.drawLine( x0, y0, x1, y1 ); } ) )
+        return;
+
+    if ( !image )
+        return;
+
+    // Clip against the viewport (not the scissor) so that the line steps
+    // through the same pixels regardless of which tile is being rasterized.
+    auto aabb = image->getAABB();
+    aabb.clamp( AABB::fromViewport( state.viewport ) );
+
+    if ( !aabb.clip( x0, y0, x1, y1 ) )
+        return;
+
+    // Only the part of the line inside of the tile (or the viewport) is stepped through.
+    dispatchBlend( state.blendMode, [&]( auto pipeline ) {
+        rasterizeLine<pipeline>( *image, x0, y0, x1, y1, getClipAABB(), state.color, state.blendMode );
+    } );
+}
+
+void Rasterizer::drawLines( std::span<const glm::vec2> points ) const
+{
+    std::vector<glm::ivec4> lines;
+    lines.reserve( points.size() / 2 );
+
+    for ( size_t i = 0; i + 1 < points.size(); i += 2 )
+        lines.emplace_back( static_cast<int>( points[i].x ), static_cast<int>( points[i].y ), static_cast<int>( points[i + 1].x ), static_cast<int>( points[i + 1].y ) );
+
+    drawLineList( std::move( lines ) );
+}
+
+void Rasterizer::drawPolyline( std::span<const glm::vec2> points, bool closed ) const
+{
+    if ( points.size() < 2 )
+        return;
+
+    std::vector<glm::ivec2> vertices;
+    vertices.reserve( points.size() + 1 );
+
+    for ( const glm::vec2& p: points )
+        vertices.emplace_back( static_cast<int>( p.x ), static_cast<int>( p.y ) );
+
+    if ( closed )
+        vertices.push_back( vertices.front() );
+
+    std::vector<glm::ivec4> lines;
+    lines.reserve( vertices.size() - 1 );
+
+    for ( size_t i = 0; i + 1 < vertices.size(); ++i )
+        lines.emplace_back( vertices[i].x, vertices[i].y, vertices[i + 1].x, vertices[i + 1].y );
+
+    drawLineList( std::move( lines ) );
+}
+
+void Rasterizer::drawLineList( std::vector<glm::ivec4> lines ) const
+{
+    Image* image = state.colorTarget;
+
+    if ( lines.empty() )
+        return;
+
+    // While recording, the lines are recorded unclipped, since the command list can be replayed to another color target.
+    if ( m_CommandList )
+    {
+        AABB linesAABB;
+        for ( const glm::ivec4& l: lines )
+        {
+            linesAABB.expand( glm::vec3 { l.x, l.y, 0 } );
+            linesAABB.expand( glm::vec3 { l.z, l.w, 0 } );
+        }
+
+        bin( linesAABB, [lines]( const Rasterizer& rasterizer ) { rasterizer.drawLineList( lines ); } );
+        return;
+    }
+
+    if ( !image )
+        return;
+
+    // Clip against the viewport (not the scissor) so that the lines step
+    // through the same pixels regardless of which tile is being rasterized.
+    auto aabb = image->getAABB();
+    aabb.clamp( AABB::fromViewport( state.viewport ) );
+
+    const int minX = static_cast<int>( aabb.min.x );
+    const int minY = static_cast<int>( aabb.min.y );
+    const int maxX = static_cast<int>( aabb.max.x );
+    const int maxY = static_cast<int>( aabb.max.y );
+
+    std::vector<glm::ivec4> bounds( lines.size() );
+
+    for ( size_t i = 0; i < lines.size(); ++i )
+    {
+        glm::ivec4& l = lines[i];
+
+        const OutCode oc0 = computeOutCode( l.x, l.y, minX, minY, maxX, maxY );
+        const OutCode oc1 = computeOutCode( l.z, l.w, minX, minY, maxX, maxY );
+
+        // Reject lines that are completely outside of one of the edges of the viewport (the bounds are left empty),
+        // and only clip the lines that cross the edges of the viewport (the same as drawLine).
+        if ( ( oc0 & oc1 ) != 0 || ( ( oc0 | oc1 ) != 0 && !aabb.clip( l.x, l.y, l.z, l.w ) ) )
+        {
+            bounds[i] = { 0, 0, -1, -1 };
+            continue;
+        }
+
+        bounds[i] = { std::min( l.x, l.z ), std::min( l.y, l.w ), std::max( l.x, l.z ), std::max( l.y, l.w ) };
+    }
+
+    drawBatch( bounds, [lines = std::make_shared<const std::vector<glm::ivec4>>( std::move( lines ) )]( const Rasterizer& rasterizer, std::span<const uint32_t> indices ) {
+        rasterizeLines( rasterizer.state, rasterizer.getClipAABB(), *lines, indices );
+    } );
+}
+
+// Source: Grok (Aug 27, 2025): What is the most efficient way to draw a circle in a 2D software rasterizer?
+void Rasterizer::drawCircle( int cx, int cy, int r ) const
+{
+    Image* image = state.colorTarget;
+
+    AABB circleAABB = AABB::fromCircle( Circle { { cx, cy }, static_cast<float>( r ) } );
+
+    if ( bin( circleAABB, [=]( const Rasterizer& rasterizer ) { rasterizer.drawCircle( cx, cy, r ); } ) )
+        return;
+
+    if ( !image )
+        return;
+
+    AABB aabb = getClipAABB();
+
+    if ( !circleAABB.intersect( aabb ) )
+        return;
+
+    switch ( state.fillMode )
+    {
+    case FillMode::WireFrame:
+        outlineEllipse( cx, cy, r, r );
+        break;
+    case FillMode::Solid:
+        fillEllipse( cx, cy, r, r );
+        break;
+    }
+}
+
+void Rasterizer::drawCircles( std::span<const Circle> circles, std::span<const Color> colors ) const
+{
+    if ( circles.empty() )
+        return;
+
+    // The batch is shared by the tiles (and the command list) that draw it.
+    auto batch = std::make_shared<const CircleBatch>( circles, colors );
+
+    std::vector<glm::ivec4> bounds;
+    bounds.reserve( batch->circles.size() );
+    for ( const glm::ivec3& c: batch->circles )
+        bounds.emplace_back( c.x - c.z, c.y - c.z, c.x + c.z, c.y + c.z );
+
+    drawBatch( bounds, [batch]( const Rasterizer& rasterizer, std::span<const uint32_t> indices ) {
+        rasterizeCircles( rasterizer.state, rasterizer.getClipAABB(), *batch, indices );
+    } );
+}
+
+void Rasterizer::drawPoints( std::span<const glm::vec2> points, std::span<const Color> colors ) const
+{
+    if ( points.empty() )
+        return;
+
+    auto batch = std::make_shared<PointBatch>();
+    batch->colors.assign( colors.begin(), colors.end() );
+    batch->points.reserve( points.size() );
+
+    std::vector<glm::ivec4> bounds;
+    bounds.reserve( points.size() );
+    for ( const glm::vec2& p: points )
+    {
+        const glm::ivec2 point { static_cast<int>( p.x ), static_cast<int>( p.y ) };
+        batch->points.push_back( point );
+        bounds.emplace_back( point.x, point.y, point.x, point.y );
+    }
+
+    drawBatch( bounds, [batch = std::shared_ptr<const PointBatch>( std::move( batch ) )]( const Rasterizer& rasterizer, std::span<const uint32_t> indices ) {
+        rasterizePoints( rasterizer.state, rasterizer.getClipAABB(), *batch, indices );
+    } );
+}
+
+void Rasterizer::drawBatch( std::span<const glm::ivec4> bounds, const std::function<void( const Rasterizer&, std::span<const uint32_t> )>& draw ) const
+{
+    Image* image = state.colorTarget;
+
+    // While recording, the whole batch is recorded as a single draw call.
+    if ( m_CommandList )
+    {
+        AABB batchAABB;
+        for ( const glm::ivec4& b: bounds )
+        {
+            batchAABB.expand( glm::vec3 { b.x, b.y, 0 } );
+            batchAABB.expand( glm::vec3 { b.z, b.w, 0 } );
+        }
+
+        bin( batchAABB, [bounds = std::vector( bounds.begin(), bounds.end() ), draw]( const Rasterizer& rasterizer ) { rasterizer.drawBatch( bounds, draw ); } );
+        return;
+    }
+
+    if ( !image )
+        return;
+
+    const AABB clip = getClipAABB();
+    const int  minX = static_cast<int>( clip.min.x );
+    const int  minY = static_cast<int>( clip.min.y );
+    const int  maxX = static_cast<int>( clip.max.x );
+    const int  maxY = static_cast<int>( clip.max.y );
+
+    if ( minX > maxX || minY > maxY )
+        return;
+
+    // Sort the primitives into screen tiles. While binning, the tiles match the tiles of the binner.
+    // Otherwise, the tiles are rows of the color target that are rasterized in parallel.
+    const int tileWidth  = m_Binner ? m_Binner->tileSize : image->getWidth();
+    const int tileHeight = m_Binner ? m_Binner->tileSize : DefaultTileSize;
+    const int columns    = ( image->getWidth() + tileWidth - 1 ) / tileWidth;
+    const int rows       = ( image->getHeight() + tileHeight - 1 ) / tileHeight;
+
+    std::vector<std::vector<uint32_t>> tiles( static_cast<size_t>( columns * rows ) );
+    std::vector<int>                   activeTiles;
+    size_t                             count = 0;
+
+    for ( size_t i = 0; i < bounds.size(); ++i )
+    {
+        const glm::ivec4& b = bounds[i];
+
+        // Cull primitives that are outside of the clip rectangle.
+        if ( b.x > maxX || b.y > maxY || b.z < minX || b.w < minY || b.x > b.z || b.y > b.w )
+            continue;
+
+        const int tileMinX = std::max( b.x, minX ) / tileWidth;
+        const int tileMinY = std::max( b.y, minY ) / tileHeight;
+        const int tileMaxX = std::min( b.z, maxX ) / tileWidth;
+        const int tileMaxY = std::min( b.w, maxY ) / tileHeight;
+
+        for ( int y = tileMinY; y <= tileMaxY; ++y )
+        {
+            for ( int x = tileMinX; x <= tileMaxX; ++x )
+            {
+                std::vector<uint32_t>& tile = tiles[y * columns + x];
+                if ( tile.empty() )
+                    activeTiles.push_back( y * columns + x );
+
+                tile.push_back( static_cast<uint32_t>( i ) );
+                ++count;
+            }
+        }
+    }
+
+    auto tileAABB = [&]( int tileIndex ) {
+        const int x = ( tileIndex % columns ) * tileWidth;
+        const int y = ( tileIndex / columns ) * tileHeight;
+
+        return AABB::fromMinMax( { x, y, 0 }, { std::min( x + tileWidth, image->getWidth() ) - 1, std::min( y + tileHeight, image->getHeight() ) - 1, 0 } );
+    };
+
+    // Only the part of a tile that is covered by the bounds of its primitives is resolved (see Image::fastClear)
+    // and marked as dirty, so a few small primitives don't clear or dirty whole tiles.
+
+    // While binning, each tile is binned as a separate draw call.
+    if ( m_Binner )
+    {
+        for ( int tileIndex: activeTiles )
+        {
+            const AABB region = boundsAABB( bounds, tiles[tileIndex] );
+
+            submit( state, tileAABB( tileIndex ), [draw, region, indices = std::move( tiles[tileIndex] )]( const Rasterizer& rasterizer ) {
+                beginWrite( *rasterizer.state.colorTarget, rasterizer.m_Scissor->clamped( region ) );
+                draw( rasterizer, indices );
+            } );
+        }
+
+        return;
+    }
+
+    // Small batches are not worth rasterizing in parallel.
+    constexpr size_t ParallelCount = 1024;
+
+    auto drawTile = [&]( int tileIndex ) {
+        Rasterizer rasterizer = *this;
+        rasterizer.m_Scissor  = m_Scissor ? tileAABB( tileIndex ).clamped( *m_Scissor ) : tileAABB( tileIndex );
+
+        beginWrite( *image, rasterizer.m_Scissor->clamped( boundsAABB( bounds, tiles[tileIndex] ) ) );
+
+        draw( rasterizer, tiles[tileIndex] );
+    };
+
+    if ( count < ParallelCount || activeTiles.size() == 1 )
+        std::for_each( activeTiles.begin(), activeTiles.end(), drawTile );
+    else
+        parallelForEach( activeTiles, drawTile );
+}
+
+void Rasterizer::drawEllipse( int cx, int cy, int rx, int ry ) const
+{
+    Image* image = state.colorTarget;
+
+    if ( rx < 0 || ry < 0 )
+        return;
+
+    AABB ellipseAABB = AABB::fromMinMax( { cx - rx, cy - ry, 0 }, { cx + rx, cy + ry, 0 } );
+
+    if ( bin( ellipseAABB, [=]( const Rasterizer& rasterizer ) { rasterizer.drawEllipse( cx, cy, rx, ry ); } ) )
+        return;
+
+    if ( !image )
+        return;
+
+    AABB aabb = getClipAABB();
+
+    if ( !ellipseAABB.intersect( aabb ) )
+        return;
+
+    switch ( state.fillMode )
+    {
+    case FillMode::WireFrame:
+        outlineEllipse( cx, cy, rx, ry );
+        break;
+    case FillMode::Solid:
+        fillEllipse( cx, cy, rx, ry );
+        break;
+    }
+}
+
+void Rasterizer::outlineEllipse( int cx, int cy, int rx, int ry ) const
+{
+    Image*     image = state.colorTarget;
+    const AABB aabb  = getClipAABB();
+
+    // Plot a pixel in each of the 4 quadrants of the ellipse (without plotting the pixels on the axes twice).
+    auto plot = [&]( int x, int y ) {
+        for ( int sx: { 1, -1 } )
+        {
+            for ( int sy: { 1, -1 } )
+            {
+                if ( ( sx < 0 && x == 0 ) || ( sy < 0 && y == 0 ) )
+                    continue;
+
+                glm::ivec2 p { cx + sx * x, cy + sy * y };
+                if ( aabb.contains( p ) )
+                    image->plot<false, true, BlendPipeline::Generic, false>( p.x, p.y, state.color, state.blendMode );
+            }
+        }
+    };
+
+    // The outline of a row are the pixels that are inside of the ellipse, but outside of the next row (away from the center),
+    // which keeps the outline connected where the ellipse is steep.
+    int y         = -1;
+    int halfWidth = 0;
+    forEachEllipseRow( rx, ry, [&]( int nextY, int nextHalfWidth ) {
+        if ( y >= 0 )
+        {
+            for ( int x = std::min( nextHalfWidth + 1, halfWidth ); x <= halfWidth; ++x )
+                plot( x, y );
+        }
+
+        y         = nextY;
+        halfWidth = nextHalfWidth;
+    } );
+
+    for ( int x = 0; x <= halfWidth; ++x )
+        plot( x, y );
+}
+
+void Rasterizer::fillEllipse( int cx, int cy, int rx, int ry ) const
+{
+    Image*     image = state.colorTarget;
+    const AABB aabb  = getClipAABB();
+
+    const int minX = static_cast<int>( aabb.min.x );
+    const int minY = static_cast<int>( aabb.min.y );
+    const int maxX = static_cast<int>( aabb.max.x );
+    const int maxY = static_cast<int>( aabb.max.y );
+
+    // Fill a row of the ellipse, clipped to the clip rectangle.
+    auto fillRow = [&]( int y, int halfWidth ) {
+        const int x0 = std::max( cx - halfWidth, minX );
+        const int x1 = std::min( cx + halfWidth, maxX );
+
+        if ( y >= minY && y <= maxY && x0 <= x1 )
+            fillSpan( *image, y, x0, x1, state.color, state.blendMode );
+    };
+
+    forEachEllipseRow( rx, ry, [&]( int y, int halfWidth ) {
+        fillRow( cy + y, halfWidth );
+
+        if ( y != 0 )
+            fillRow( cy - y, halfWidth );
+    } );
+}
+
+void Rasterizer::drawTriangle( glm::ivec2 p0, glm::ivec2 p1, glm::ivec2 p2 ) const
+{
+    Image* image = state.colorTarget;
+
+    if ( bin( AABB::fromTriangle( p0, p1, p2 ), [=]( const Rasterizer& rasterizer ) { rasterizer.drawTriangle( p0, p1, p2 ); } ) )
+        return;
 
     if ( !image )
         return;
@@ -362,7 +2152,7 @@ void Rasterizer::drawTriangle( glm::ivec2 p0, glm::ivec2 p1, glm::ivec2 p2 ) con
             break;
         }
 
-        auto aabb         = image->getAABB().clamped( AABB { state.viewport } );
+        auto aabb         = getClipAABB();
         auto triangleAABB = AABB::fromTriangle( p0, p1, p2 );
 
         if ( !triangleAABB.intersect( aabb ) )
@@ -378,20 +2168,11 @@ void Rasterizer::drawTriangle( glm::ivec2 p0, glm::ivec2 p1, glm::ivec2 p2 ) con
         glm::ivec2 p { minX, minY };
 
         // Edge setup.
-        Edge2D e = Edge2D { p0, p1, p2, p };  // Flip winding order if vertices are the wrong way around.
+        const Edge2D e[] = { { p0, p1, p2, p } };
 
-        for ( p.y = minY; p.y <= maxY; p.y++ )
-        {
-            for ( p.x = minX; p.x <= maxX; p.x++ )
-            {
-                if ( e.inside() )
-                    image->plot<false>( p.x, p.y, state.color, state.blendMode );
-
-                e.stepX();
-            }
-
-            e.stepY();
-        }
+        forEachSpan( e, minX, minY, maxX, maxY, [&]( int y, int x0, int x1, size_t ) {
+            fillSpan( *image, y, x0, x1, state.color, state.blendMode );
+        } );
     }
     break;
     }
@@ -401,9 +2182,14 @@ void Rasterizer::drawTriangle( Vertex2D v0, Vertex2D v1, Vertex2D v2, const Imag
 {
     Image* image = state.colorTarget;
 
+    if ( bin( AABB::fromTriangle( v0.position, v1.position, v2.position ), [=, &texture]( const Rasterizer& rasterizer ) { rasterizer.drawTriangle( v0, v1, v2, texture, samplerState, _blendMode ); } ) )
+        return;
+
     if ( !image )
         return;
 
+    texture.resolveClear();
+
     const int area = orient2D( v0.position, v1.position, v2.position );
 
     if ( area == 0 )  // Ignore degenerate triangles.
@@ -427,7 +2213,7 @@ void Rasterizer::drawTriangle( Vertex2D v0, Vertex2D v1, Vertex2D v2, const Imag
     }
 
     const BlendMode blendMode    = _blendMode.value_or( state.blendMode );
-    auto            aabb         = image->getAABB().clamped( AABB { state.viewport } );
+    auto            aabb         = getClipAABB();
     auto            triangleAABB = AABB::fromTriangle( v0.position, v1.position, v2.position );
 
     if ( !triangleAABB.intersect( aabb ) )
@@ -443,41 +2229,32 @@ void Rasterizer::drawTriangle( Vertex2D v0, Vertex2D v1, Vertex2D v2, const Imag
     glm::ivec2 p { minX, minY };
 
     // Edge setup.
-    Edge2D e = Edge2D { v0.position, v1.position, v2.position, p };
-
-    // Compute valid texture coordinate bounds from vertices to prevent bleeding into tile margins
-    const glm::vec2 minTexCoord = glm::min( glm::min( v0.texCoord, v1.texCoord ), v2.texCoord );
-    const glm::vec2 maxTexCoord = glm::max( glm::max( v0.texCoord, v1.texCoord ), v2.texCoord );
+    const Edge2D e[] = { { v0.position, v1.position, v2.position, p } };
 
-    for ( p.y = minY; p.y <= maxY; p.y++ )
-    {
-        for ( p.x = minX; p.x <= maxX; p.x++ )
-        {
-            if ( e.inside() )
-            {
-                const glm::vec3 bc       = e.barycentric();
-                const glm::vec2 texCoord = glm::clamp( math::interpolate( v0.texCoord, v1.texCoord, v2.texCoord, bc ), minTexCoord, maxTexCoord );
-                const Color     color    = interpolate( v0.color, v1.color, v2.color, bc );
-                const Color     srcColor = texture.sample( texCoord.x, texCoord.y, samplerState ) * color;
-                image->plot<false>( p.x, p.y, srcColor, blendMode );
-            }
+    const Vertex2D verts[] = {
+        v0, v1, v2
+    };
 
-            e.stepX();
-        }
+    const uint32_t indices[] = {
+        0, 1, 2
+    };
 
-        e.stepY();
-    }
+    rasterizeTextured( *image, e, verts, indices, minX, minY, maxX, maxY, texture, samplerState, blendMode );
 }
 
 void Rasterizer::drawQuad( glm::ivec2 p0, glm::ivec2 p1, glm::ivec2 p2, glm::ivec2 p3 ) const
 {
     Image* image = state.colorTarget;
 
+    AABB srcAABB = AABB { p0, p1, p2, p3 };
+
+    if ( bin( srcAABB, [=]( const Rasterizer& rasterizer ) { rasterizer.drawQuad( p0, p1, p2, p3 ); } ) )
+        return;
+
     if ( !image )
         return;
 
-    AABB dstAABB = image->getAABB().clamped( AABB { state.viewport } );
-    AABB srcAABB = AABB { p0, p1, p2, p3 };
+    AABB dstAABB = getClipAABB();
 
     if ( !srcAABB.intersect( dstAABB ) )
         return;
@@ -530,29 +2307,14 @@ void Rasterizer::drawQuad( glm::ivec2 p0, glm::ivec2 p1, glm::ivec2 p2, glm::ive
         glm::ivec2 p { minX, minY };
 
         // Edge setup
-        Edge2D e[] = {
+        const Edge2D e[] = {
             { p0, p1, p2, p },
             { p2, p3, p0, p },
         };
 
-        for ( p.y = minY; p.y <= maxY; ++p.y )
-        {
-            for ( p.x = minX; p.x <= maxX; ++p.x )
-            {
-                for ( const auto& i: e )
-                {
-                    if ( i.inside() )
-                    {
-                        image->plot<false>( p.x, p.y, state.color, state.blendMode );
-                    }
-                }
-
-                e[0].stepX();
-                e[1].stepX();
-            }
-            e[0].stepY();
-            e[1].stepY();
-        }
+        forEachSpan( e, minX, minY, maxX, maxY, [&]( int y, int x0, int x1, size_t ) {
+            fillSpan( *image, y, x0, x1, state.color, state.blendMode );
+        } );
     }
     break;
     }
@@ -562,9 +2324,19 @@ void Rasterizer::drawQuad( Vertex2D v0, Vertex2D v1, Vertex2D v2, Vertex2D v3, c
 {
     Image* dstImage = state.colorTarget;
 
+    // Compute the AABB over the quad vertices.
+    AABB srcAABB = AABB {
+        v0.position, v1.position, v2.position, v3.position
+    };
+
+    if ( bin( srcAABB, [=, &texture]( const Rasterizer& rasterizer ) { rasterizer.drawQuad( v0, v1, v2, v3, texture, samplerState, _blendMode ); } ) )
+        return;
+
     if ( !dstImage )
         return;
 
+    texture.resolveClear();
+
     // Check culling for both triangles of the quad.
     int area1 = orient2D( v0.position, v1.position, v2.position );
     int area2 = orient2D( v2.position, v3.position, v0.position );
@@ -594,12 +2366,7 @@ void Rasterizer::drawQuad( Vertex2D v0, Vertex2D v1, Vertex2D v2, Vertex2D v3, c
     }
 
     BlendMode blendMode = _blendMode.value_or( state.blendMode );
-    AABB      dstAABB   = dstImage->getAABB().clamped( AABB::fromViewport( state.viewport ) );
-
-    // Compute the AABB over the quad vertices.
-    AABB srcAABB = AABB {
-        v0.position, v1.position, v2.position, v3.position
-    };
+    AABB      dstAABB   = getClipAABB();
 
     // If the sprite AABB doesn't overlap with the destination AABB.
     if ( !srcAABB.intersect( dstAABB ) )
@@ -615,7 +2382,7 @@ void Rasterizer::drawQuad( Vertex2D v0, Vertex2D v1, Vertex2D v2, Vertex2D v3, c
 
     glm::ivec2 p { minX, minY };
 
-    Edge2D e[] {
+    const Edge2D e[] {
         Edge2D { v0.position, v1.position, v2.position, p },
         Edge2D { v2.position, v3.position, v0.position, p }
     };
@@ -629,57 +2396,128 @@ void Rasterizer::drawQuad( Vertex2D v0, Vertex2D v1, Vertex2D v2, Vertex2D v3, c
         2, 3, 0
     };
 
-    // Compute valid texture coordinate bounds from vertices to prevent bleeding into tile margins
-    const glm::vec2 minTexCoord = glm::min( glm::min( v0.texCoord, v1.texCoord ), glm::min( v2.texCoord, v3.texCoord ) );
-    const glm::vec2 maxTexCoord = glm::max( glm::max( v0.texCoord, v1.texCoord ), glm::max( v2.texCoord, v3.texCoord ) );
+    rasterizeTextured( *dstImage, e, verts, indices, minX, minY, maxX, maxY, texture, samplerState, blendMode );
+}
+
+void Rasterizer::drawTriangles( std::span<const Vertex2D> vertices, std::span<const uint32_t> indices, const Image& texture, const SamplerState& samplerState, std::optional<BlendMode> _blendMode ) const
+{
+    Image* image = state.colorTarget;
+
+    const size_t count = ( indices.empty() ? vertices.size() : indices.size() ) / 3;
+    if ( count == 0 )
+        return;
+
+    // The binned draw call holds a copy of the vertices and indices, since the spans may not outlive this call.
+    if ( bin( batchAABB( vertices ), [vertices = std::vector( vertices.begin(), vertices.end() ), indices = std::vector( indices.begin(), indices.end() ), &texture, samplerState, _blendMode]( const Rasterizer& rasterizer ) { rasterizer.drawTriangles( vertices, indices, texture, samplerState, _blendMode ); } ) )
+        return;
+
+    if ( !image )
+        return;
+
+    texture.resolveClear();
+
+    const BlendMode blendMode = _blendMode.value_or( state.blendMode );
+    const AABB      clipAABB  = getClipAABB();
+
+    // Shared vertices are only snapped once.
+    const std::vector<glm::ivec2> positions = snapPositions( vertices );
+
+    auto index = [&indices]( size_t i ) {
+        return indices.empty() ? static_cast<uint32_t>( i ) : indices[i];
+    };
 
-    for ( p.y = minY; p.y <= maxY; ++p.y )
+    for ( size_t i = 0; i < count; ++i )
     {
-        for ( p.x = minX; p.x <= maxX; ++p.x )
-        {
-            for ( uint32_t i = 0; i < 2; ++i )
-            {
-                const Edge2D& edge = e[i];
-                if ( edge.inside() )
-                {
-                    const uint32_t i0 = indices[i * 3 + 0];
-                    const uint32_t i1 = indices[i * 3 + 1];
-                    const uint32_t i2 = indices[i * 3 + 2];
+        const uint32_t triangle[] = {
+            index( i * 3 + 0 ), index( i * 3 + 1 ), index( i * 3 + 2 )
+        };
 
-                    const Vertex2D& a = verts[i0];
-                    const Vertex2D& b = verts[i1];
-                    const Vertex2D& c = verts[i2];
+        const glm::ivec2& p0 = positions[triangle[0]];
+        const glm::ivec2& p1 = positions[triangle[1]];
+        const glm::ivec2& p2 = positions[triangle[2]];
 
-                    const glm::vec3 bc       = edge.barycentric();
-                    const glm::vec2 texCoord = glm::clamp( math::interpolate( a.texCoord, b.texCoord, c.texCoord, bc ), minTexCoord, maxTexCoord );
+        const int area = orient2D( p0, p1, p2 );
 
-                    const Color color    = interpolate( a.color, b.color, c.color, bc );
-                    const Color srcColor = texture.sample( texCoord.x, texCoord.y, samplerState ) * color;
-                    dstImage->plot<false>( p.x, p.y, srcColor, blendMode );
-                }
-            }
+        if ( area == 0 || isCulled( state, isFrontFacing( state, area ) ) )
+            continue;
 
-            e[0].stepX();
-            e[1].stepX();
-        }
+        const AABB triangleAABB = AABB::fromTriangle( vertices[triangle[0]].position, vertices[triangle[1]].position, vertices[triangle[2]].position );
+        AABB       aabb         = clipAABB;
+
+        if ( !triangleAABB.intersect( aabb ) )
+            continue;
+
+        aabb.clamp( triangleAABB );
+
+        const int minX = static_cast<int>( aabb.min.x );
+        const int minY = static_cast<int>( aabb.min.y );
+        const int maxX = static_cast<int>( aabb.max.x );
+        const int maxY = static_cast<int>( aabb.max.y );
+
+        const Edge2D e[] = { { p0, p1, p2, { minX, minY } } };
+
+        rasterizeTextured( *image, e, vertices.data(), triangle, minX, minY, maxX, maxY, texture, samplerState, blendMode );
+    }
+}
+
+void Rasterizer::drawQuads( std::span<const Vertex2D> vertices, std::span<const uint32_t> indices, const Image& texture, const SamplerState& samplerState, std::optional<BlendMode> _blendMode ) const
+{
+    Image* image = state.colorTarget;
+
+    const size_t count = ( indices.empty() ? vertices.size() : indices.size() ) / 4;
+    if ( count == 0 )
+        return;
+
+    // The binned draw call holds a copy of the vertices and indices, since the spans may not outlive this call.
+    if ( bin( batchAABB( vertices ), [vertices = std::vector( vertices.begin(), vertices.end() ), indices = std::vector( indices.begin(), indices.end() ), &texture, samplerState, _blendMode]( const Rasterizer& rasterizer ) { rasterizer.drawQuads( vertices, indices, texture, samplerState, _blendMode ); } ) )
+        return;
+
+    if ( !image )
+        return;
+
+    texture.resolveClear();
+
+    const BlendMode blendMode = _blendMode.value_or( state.blendMode );
+    const AABB      clipAABB  = getClipAABB();
+
+    // Shared vertices are only snapped once.
+    const std::vector<glm::ivec2> positions = snapPositions( vertices );
+
+    auto index = [&indices]( size_t i ) {
+        return indices.empty() ? static_cast<uint32_t>( i ) : indices[i];
+    };
+
+    // The quads are culled and clipped in SIMD batches, and only the quads that survive are rasterized.
+    for ( const QuadSetup& setup: setupQuads( vertices, count, index, state, clipAABB ) )
+    {
+        const uint32_t quad[] = {
+            index( setup.quad * 4 + 0 ), index( setup.quad * 4 + 1 ), index( setup.quad * 4 + 2 ), index( setup.quad * 4 + 3 )
+        };
 
-        e[0].stepY();
-        e[1].stepY();
+        rasterizeQuad( *image, vertices, positions, quad, setup, texture, samplerState, blendMode );
     }
 }
 
 void Rasterizer::drawAABB( math::AABB aabb ) const
 {
-    Image*   image    = state.colorTarget;
-    Viewport viewport = state.viewport;
+    Image* image = state.colorTarget;
+
+    // The coordinates of the AABB are truncated to pixels, so a tile that contains the first pixel
+    // of the AABB is drawn (and binned), even if it doesn't contain the fractional min point.
+    const AABB pixelBounds = AABB::fromMinMax( glm::floor( aabb.min ), glm::floor( aabb.max ) );
+
+    // A solid AABB without blending replaces every pixel that it covers.
+    const std::optional<AABB> overwritten = state.fillMode == FillMode::Solid ? opaqueRegion( state.blendMode, pixelBounds ) : std::nullopt;
+
+    if ( bin( pixelBounds, [=]( const Rasterizer& rasterizer ) { rasterizer.drawAABB( aabb ); }, overwritten ) )
+        return;
 
     if ( !image )
         return;
 
-    AABB imageAABB = image->getAABB();
-    imageAABB.clamp( AABB::fromViewport( viewport ) );
+    AABB imageAABB = getClipAABB();
 
-    if ( !aabb.intersect( imageAABB ) )
+    if ( !pixelBounds.intersect( imageAABB ) )
         return;
 
     switch ( state.fillMode )
@@ -691,30 +2529,56 @@ void Rasterizer::drawAABB( math::AABB aabb ) const
         drawLine( aabb.min.x, aabb.max.y, aabb.min.x, aabb.min.y );
         break;
     case FillMode::Solid:
-        aabb.clamp( imageAABB );
-        for ( int y = static_cast<int>( aabb.min.y ); y <= static_cast<int>( aabb.max.y ); ++y )
+    {
+        const AABB fill = pixelBounds.clamped( imageAABB );
+
+        const int minX = static_cast<int>( fill.min.x );
+        const int minY = static_cast<int>( fill.min.y );
+        const int maxX = static_cast<int>( fill.max.x );
+        const int maxY = static_cast<int>( fill.max.y );
+
+        // The clip rect of a tile can be outside of the viewport when binning.
+        if ( minX > maxX || minY > maxY )
+            break;
+
+        // If the rows span the entire width of the color target, they are contiguous in memory and filled as a single span.
+        if ( minX == 0 && maxX == image->getWidth() - 1 )
         {
-            for ( int x = static_cast<int>( aabb.min.x ); x <= static_cast<int>( aabb.max.x ); ++x )
-            {
-                image->plot<false>( x, y, state.color, state.blendMode );
-            }
+            state.blendMode.blendSpan( state.color, image->data() + static_cast<size_t>( minY ) * image->getWidth(), static_cast<size_t>( maxY - minY + 1 ) * image->getWidth() );
+            break;
         }
-        break;
+
+        for ( int y = minY; y <= maxY; ++y )
+        {
+            fillSpan( *image, y, minX, maxX, state.color, state.blendMode );
+        }
+    }
+    break;
     }
 }
 
 void Rasterizer::drawImage( const Image& srcImage, int x, int y ) const
 {
     Image* dstImage = state.colorTarget;
-    if ( !dstImage )
-        return;
 
     int srcW = srcImage.getWidth();
     int srcH = srcImage.getHeight();
+
+    const AABB dstBounds = AABB::fromMinMax( { x, y, 0 }, { x + srcW - 1, y + srcH - 1, 0 } );
+
+    if ( bin( dstBounds, [&srcImage, x, y]( const Rasterizer& rasterizer ) { rasterizer.drawImage( srcImage, x, y ); }, opaqueRegion( state.blendMode, dstBounds ) ) )
+        return;
+
+    if ( !dstImage )
+        return;
+
+    // The source image may be a render target that was cleared lazily (see Image::fastClear).
+    srcImage.resolveClear();
+
     int dstW = dstImage->getWidth();
 
     // Clamp destination rectangle to viewport and image bounds
-    AABB dstAABB    = dstImage->getAABB().clamped( AABB::fromViewport( state.viewport ) );
+    AABB dstAABB    = getClipAABB();
     int  clipLeft   = std::max( static_cast<int>( dstAABB.min.x ), x );
     int  clipTop    = std::max( static_cast<int>( dstAABB.min.y ), y );
     int  clipRight  = std::min( static_cast<int>( dstAABB.max.x ), x + srcW - 1 );
@@ -723,31 +2587,28 @@ void Rasterizer::drawImage( const Image& srcImage, int x, int y ) const
     if ( clipLeft > clipRight || clipTop > clipBottom )
         return;
 
-    const Color* src       = srcImage.data();
-    Color*       dst       = dstImage->data();
-    BlendMode    blendMode = state.blendMode;
-    Color        color     = state.color;
+    const Color*  src          = srcImage.data();
+    Color*        dst          = dstImage->data();
+    BlendMode     blendMode    = state.blendMode;
+    Color         color        = state.color;
+    CoverageMask* coverageMask = getCoverageMask( blendMode );
 
     for ( int dy = clipTop; dy <= clipBottom; ++dy )
     {
-        for ( int dx = clipLeft; dx <= clipRight; ++dx )
-        {
-            int sx = dx - x;
-            int sy = dy - y;
+        int sy = dy - y;
 
-            Color sC = src[sy * srcW + sx] * color;
-            Color dC = dst[dy * dstW + dx];
+        forEachVisibleSpan( coverageMask, dy, clipLeft, clipRight, [&]( int dx, int n ) {
+            const Color* s = src + sy * srcW + ( dx - x );
 
-            dst[dy * dstW + dx] = blendMode.Blend( sC, dC );
-        }
+            blendMode.blendSpan( s, dst + dy * dstW + dx, n, color );
+            coverSpan( coverageMask, blendMode, dy, dx, s, n, color );
+        } );
     }
 }
 
 void Rasterizer::drawImage( const Image& srcImage, std::optional<sr::math::RectI> srcRect, std::optional<sr::math::RectI> dstRect ) const
 {
     Image* dstImage = state.colorTarget;
-    if ( !dstImage )
-        return;
 
     // Get source rectangle
     int srcX = 0, srcY = 0, srcW = srcImage.getWidth(), srcH = srcImage.getHeight();
@@ -769,8 +2630,21 @@ void Rasterizer::drawImage( const Image& srcImage, std::optional<sr::math::RectI
         dstH = dstRect->height;
     }
 
+    const AABB dstBounds = AABB::fromMinMax( { dstX, dstY, 0 }, { dstX + dstW - 1, dstY + dstH - 1, 0 } );
+
+    // Every pixel of the destination rectangle is replaced if blending is disabled (and there are source pixels to sample).
+    const std::optional<AABB> overwritten = srcImage.getWidth() > 0 && srcImage.getHeight() > 0 ? opaqueRegion( state.blendMode, dstBounds ) : std::nullopt;
+
+    if ( bin( dstBounds, [&srcImage, srcRect, dstRect]( const Rasterizer& rasterizer ) { rasterizer.drawImage( srcImage, srcRect, dstRect ); }, overwritten ) )
+        return;
+
+    if ( !dstImage )
+        return;
+
+    srcImage.resolveClear();
+
     // Clamp destination rectangle to viewport and image bounds
-    AABB dstAABB    = dstImage->getAABB().clamped( AABB::fromViewport( state.viewport ) );
+    AABB dstAABB    = getClipAABB();
     int  clipLeft   = std::max( static_cast<int>( dstAABB.min.x ), dstX );
     int  clipTop    = std::max( static_cast<int>( dstAABB.min.y ), dstY );
     int  clipRight  = std::min( static_cast<int>( dstAABB.max.x ), dstX + dstW - 1 );
@@ -779,36 +2653,64 @@ void Rasterizer::drawImage( const Image& srcImage, std::optional<sr::math::RectI
     if ( clipLeft > clipRight || clipTop > clipBottom )
         return;
 
-    // Calculate scaling factors if needed
-    float scaleX = static_cast<float>( srcW ) / dstW;
-    float scaleY = static_cast<float>( srcH ) / dstH;
-
-    const Color* src = srcImage.data();
-    Color*       dst = dstImage->data();
-    int          sW  = srcImage.getWidth();
-    int          dW  = dstImage->getWidth();
+    const Color* src   = srcImage.data();
+    Color*       dst   = dstImage->data();
+    const int    sW    = srcImage.getWidth();
+    const int    sH    = srcImage.getHeight();
+    const int    dW    = dstImage->getWidth();
+    const int    width = clipRight - clipLeft + 1;
 
-    BlendMode blendMode = state.blendMode;
-    Color     color     = state.color;
+    const BlendMode blendMode    = state.blendMode;
+    const Color     color        = state.color;
+    CoverageMask*   coverageMask = getCoverageMask( blendMode );
 
-    for ( int y = clipTop; y <= clipBottom; ++y )
+    // Destination pixel x maps to source texel srcX + ( x - dstX ) * srcW / dstW.
+    // The source column of every destination column is the same for every row, so it's only computed (and clamped) once.
+    std::vector<int> columns( static_cast<size_t>( width ) );
     {
-        for ( int x = clipLeft; x <= clipRight; ++x )
+        ScaleDDA u { static_cast<int64_t>( clipLeft - dstX ) * srcW, srcW, dstW };
+        for ( int& column: columns )
         {
-            // Map destination pixel to source pixel
-            int u = srcX + static_cast<int>( ( x - dstX ) * scaleX );
-            int v = srcY + static_cast<int>( ( y - dstY ) * scaleY );
+            column = std::clamp( srcX + u.texel, 0, sW - 1 );
+            u.next();
+        }
+    }
+
+    // Blit the rows [top, bottom].
+    auto blitRows = [&]( int top, int bottom ) {
+        // The scaled source pixels of a row are gathered before they are blended with the destination.
+        std::vector<Color> row( static_cast<size_t>( width ) );
 
-            // Clamp source coordinates
-            u = std::clamp( u, 0, srcImage.getWidth() - 1 );
-            v = std::clamp( v, 0, srcImage.getHeight() - 1 );
+        ScaleDDA v { static_cast<int64_t>( top - dstY ) * srcH, srcH, dstH };
+        for ( int y = top; y <= bottom; ++y, v.next() )
+        {
+            const Color* srcRow = src + std::clamp( srcY + v.texel, 0, sH - 1 ) * sW;
 
-            Color sC = src[v * sW + u] * color;
-            Color dC = dst[y * dW + x];
+            forEachVisibleSpan( coverageMask, y, clipLeft, clipRight, [&]( int x, int n ) {
+                for ( int i = 0; i < n; ++i )
+                    row[i] = srcRow[columns[x - clipLeft + i]];
 
-            dst[y * dW + x] = blendMode.Blend( sC, dC );
+                blendMode.blendSpan( row.data(), dst + y * dW + x, n, color );
+                coverSpan( coverageMask, blendMode, y, x, row.data(), n, color );
+            } );
         }
+    };
+
+    // Large blits (like full-screen backgrounds) are split into bands of rows that are blitted in parallel.
+    constexpr int BandHeight    = 32;
+    constexpr int ParallelCount = 256 * 256;
+
+    const int height = clipBottom - clipTop + 1;
+    if ( width * height < ParallelCount || height <= BandHeight )
+    {
+        blitRows( clipTop, clipBottom );
+        return;
     }
+
+    parallelFor( 0, ( height + BandHeight - 1 ) / BandHeight, [&]( int band ) {
+        const int top = clipTop + band * BandHeight;
+        blitRows( top, std::min( top + BandHeight - 1, clipBottom ) );
+    } );
 }
 
 void Rasterizer::drawSprite( const Sprite& sprite, int _x, int _y ) const
@@ -816,15 +2718,25 @@ void Rasterizer::drawSprite( const Sprite& sprite, int _x, int _y ) const
     const Image* srcImage = sprite.getImage().get();
     Image*       dstImage = state.colorTarget;
 
-    if ( !srcImage || !dstImage )
+    if ( !srcImage )
+        return;
+
+    const glm::ivec2 size = sprite.getSize();
+
+    const AABB dstBounds = AABB::fromMinMax( { _x, _y, 0 }, { _x + size.x - 1, _y + size.y - 1, 0 } );
+
+    if ( bin( dstBounds, [sprite, _x, _y]( const Rasterizer& rasterizer ) { rasterizer.drawSprite( sprite, _x, _y ); }, opaqueRegion( sprite.getBlendMode(), dstBounds ) ) )
+        return;
+
+    if ( !dstImage )
         return;
 
-    const Color      color        = sprite.getColor() * state.color;
-    const BlendMode  blendMode    = sprite.getBlendMode();
-    const AABB       viewportAABB = AABB::fromViewport( state.viewport );
-    const AABB       dstAABB      = dstImage->getAABB().clamped( viewportAABB );
-    const glm::ivec2 size         = sprite.getSize();
-    glm::ivec2       uv           = sprite.getUV();
+    srcImage->resolveClear();
+
+    const Color     color     = sprite.getColor() * state.color;
+    const BlendMode blendMode = sprite.getBlendMode();
+    const AABB      dstAABB   = getClipAABB();
+    glm::ivec2      uv        = sprite.getUV();
 
     // Compute viewport clipping bounds.
     const int clipLeft   = std::max( static_cast<int>( dstAABB.min.x ), _x );
@@ -833,32 +2745,31 @@ void Rasterizer::drawSprite( const Sprite& sprite, int _x, int _y ) const
     const int clipBottom = std::min( static_cast<int>( dstAABB.max.y ), _y + size.y - 1 );
 
     // Check if the sprite is completely off-screen.
-    if ( clipLeft >= clipRight || clipTop >= clipBottom )
+    if ( clipLeft > clipRight || clipTop > clipBottom )
         return;
 
     // Adjust sprite UV based on clipping.
     uv.x += clipLeft - _x;
     uv.y += clipTop - _y;
 
-    const Color* src = srcImage->data();
-    Color*       dst = dstImage->data();
+    const Color*  src          = srcImage->data();
+    Color*        dst          = dstImage->data();
+    CoverageMask* coverageMask = getCoverageMask( blendMode );
 
     int sW = srcImage->getWidth();  // Source image width.
     int dW = dstImage->getWidth();  // Destination image width.
 
     for ( int y = clipTop; y <= clipBottom; ++y )
     {
-        for ( int x = clipLeft; x <= clipRight; ++x )
-        {
-            // Compute clipped UV sprite texture coordinates.
-            int u = uv.x + ( x - clipLeft );
-            int v = uv.y + ( y - clipTop );
+        // Compute clipped UV sprite texture coordinates.
+        int v = uv.y + ( y - clipTop );
 
-            Color sC = src[v * sW + u] * color;
-            Color dC = dst[y * dW + x];
+        forEachVisibleSpan( coverageMask, y, clipLeft, clipRight, [&]( int x, int n ) {
+            const Color* s = src + v * sW + uv.x + ( x - clipLeft );
 
-            dst[y * dW + x] = blendMode.Blend( sC, dC );
-        }
+            blendMode.blendSpan( s, dst + y * dW + x, n, color );
+            coverSpan( coverageMask, blendMode, y, x, s, n, color );
+        } );
     }
 }
 
@@ -867,7 +2778,7 @@ void Rasterizer::drawSprite( const Sprite& sprite, const glm::mat3& transform )
     const Image* srcImage = sprite.getImage().get();
     Image*       dstImage = state.colorTarget;
 
-    if ( !srcImage || !dstImage )
+    if ( !srcImage )
         return;
 
     // If the top-left 2x2 area of the matrix is identity, then there is no
@@ -886,6 +2797,23 @@ void Rasterizer::drawSprite( const Sprite& sprite, const glm::mat3& transform )
     const glm::vec2 uv    = sprite.getUV();
     const glm::vec2 size  = sprite.getSize();
 
+    // If the matrix only scales (or flips) and translates, the sprite is drawn as a scaled blit.
+    if ( isScaleTranslate( transform ) )
+    {
+        const glm::vec2 p0 = transform * glm::vec3 { 0, 0, 1 };
+        const glm::vec2 p1 = transform * glm::vec3 { size, 1 };
+
+        if ( bin( AABB { p0, p1 }, [sprite, transform]( const Rasterizer& rasterizer ) { rasterizer.drawSprite( sprite, transform ); } ) )
+            return;
+
+        if ( !dstImage )
+            return;
+
+        drawScaled( *srcImage, p0, p1, sprite.getUV(), sprite.getUV() + sprite.getSize(), color, sprite.getBlendMode() );
+
+        return;
+    }
+
     // With pixel center sampling, adjust vertex texture coordinates
     // Position 0.5 (first pixel center) maps to texture coordinate 0
     // Position 31.5 (last pixel center) maps to texture coordinate 31
@@ -902,9 +2830,98 @@ void Rasterizer::drawSprite( const Sprite& sprite, const glm::mat3& transform )
         v.position = transform * glm::vec3 { v.position, 1.0f };
     }
 
+    // The binned draw call holds a copy of the sprite to keep the sprite's image alive until it is rasterized.
+    if ( bin( AABB { verts[0].position, verts[1].position, verts[2].position, verts[3].position }, [sprite, verts]( const Rasterizer& rasterizer ) { rasterizer.drawQuad( verts[0], verts[1], verts[2], verts[3], *sprite.getImage(), SamplerState {}, sprite.getBlendMode() ); } ) )
+        return;
+
+    if ( !dstImage )
+        return;
+
     drawQuad( verts[0], verts[1], verts[2], verts[3], *srcImage, SamplerState {}, sprite.getBlendMode() );
 }
 
+void Rasterizer::drawScaled( const Image& image, const glm::vec2& p0, const glm::vec2& p1, const glm::ivec2& t0, const glm::ivec2& t1, const Color& color, const BlendMode& blendMode ) const
+{
+    Image* dstImage = state.colorTarget;
+
+    // Snap the corners to pixels the same way as the edge functions of a textured quad.
+    const glm::ivec2 P0 = p0;
+    const glm::ivec2 P1 = p1;
+
+    // The winding order of the quad is reversed if the image is flipped on one of the axes.
+    const int area = ( P1.x - P0.x ) * ( P1.y - P0.y );
+    if ( area == 0 )
+        return;
+
+    bool ccw     = area > 0;
+    bool isFront = state.frontCounterClockwise ? ccw : !ccw;
+
+    switch ( state.cullMode )
+    {
+    case CullMode::Front:
+        if ( isFront )
+            return;
+        break;
+    case CullMode::Back:
+        if ( !isFront )
+            return;
+        break;
+    case CullMode::None:
+        break;
+    }
+
+    // The pixels [min( P0, P1 ), max( P0, P1 ) - 1] are drawn.
+    const AABB dstBounds = AABB::fromMinMax( { glm::min( P0, P1 ), 0 }, { glm::max( P0, P1 ) - 1, 0 } );
+
+    if ( bin( AABB { p0, p1 }, [&image, p0, p1, t0, t1, color, blendMode]( const Rasterizer& rasterizer ) { rasterizer.drawScaled( image, p0, p1, t0, t1, color, blendMode ); }, opaqueRegion( blendMode, dstBounds ) ) )
+        return;
+
+    if ( !dstImage )
+        return;
+
+    image.resolveClear();
+
+    const AABB dstAABB    = getClipAABB();
+    const int  clipLeft   = std::max( static_cast<int>( dstAABB.min.x ), std::min( P0.x, P1.x ) );
+    const int  clipTop    = std::max( static_cast<int>( dstAABB.min.y ), std::min( P0.y, P1.y ) );
+    const int  clipRight  = std::min( static_cast<int>( dstAABB.max.x ), std::max( P0.x, P1.x ) - 1 );
+    const int  clipBottom = std::min( static_cast<int>( dstAABB.max.y ), std::max( P0.y, P1.y ) - 1 );
+
+    if ( clipLeft > clipRight || clipTop > clipBottom )
+        return;
+
+    const Color*  src          = image.data();
+    Color*        dst          = dstImage->data();
+    const int     sW           = image.getWidth();
+    const int     dW           = dstImage->getWidth();
+    CoverageMask* coverageMask = getCoverageMask( blendMode );
+
+    // The source texels of a row are gathered in chunks before they are blended with the destination.
+    constexpr int ChunkSize = 64;
+    Color         row[ChunkSize];
+
+    ScaleDDA v = ScaleDDA::pixelCenter( clipTop, P0.y, P1.y, t1.y - t0.y );
+    for ( int y = clipTop; y <= clipBottom; ++y, v.next() )
+    {
+        const Color* srcRow = src + ( t0.y + v.texel ) * sW + t0.x;
+
+        forEachVisibleSpan( coverageMask, y, clipLeft, clipRight, [&]( int first, int count ) {
+            const int last = first + count - 1;
+
+            ScaleDDA u = ScaleDDA::pixelCenter( first, P0.x, P1.x, t1.x - t0.x );
+            for ( int x = first; x <= last; x += ChunkSize )
+            {
+                const int n = std::min( ChunkSize, last - x + 1 );
+                for ( int i = 0; i < n; ++i, u.next() )
+                    row[i] = srcRow[u.texel];
+
+                blendMode.blendSpan( row, dst + y * dW + x, n, color );
+                coverSpan( coverageMask, blendMode, y, x, row, n, color );
+            }
+        } );
+    }
+}
+
 void Rasterizer::drawTileMap( const TileMap& tileMap, int x, int y ) const
 {
     // int tileX        = 0;
@@ -929,8 +2946,8 @@ void Rasterizer::drawTileMap( const TileMap& tileMap, int x, int y ) const
     //     tileY += spriteHeight;
     // }
 
-    auto range = std::views::iota( 0, rows * columns );
-    std::for_each( std::execution::par_unseq, range.begin(), range.end(), [this, x, y, columns, spriteWidth, spriteHeight, &tileMap]( int n ) {
+    auto range    = std::views::iota( 0, rows * columns );
+    auto drawTile = [this, x, y, columns, spriteWidth, spriteHeight, &tileMap]( int n ) {
         int i        = n / columns;
         int j        = n % columns;
         int spriteId = tileMap.getSpriteId( j, i );
@@ -940,7 +2957,9 @@ void Rasterizer::drawTileMap( const TileMap& tileMap, int x, int y ) const
             int tileY = i * spriteHeight;
             drawSprite( tileMap.getSprite( j, i ), x + tileX, y + tileY );
         }
-    } );
+    };
+
+    forEachDrawCall( range, drawTile );
 }
 
 void Rasterizer::drawTileMap( const TileMap& tileMap, const glm::mat3& transform ) const
@@ -983,19 +3002,78 @@ void Rasterizer::drawTileMap( const TileMap& tileMap, const glm::mat3& transform
     //    drawQuad( v0, v1, v2, v3, *image, AddressMode::Clamp, blendMode );
     //}
 
-    std::for_each( std::execution::par_unseq, vb.begin(), vb.end(), [&transform]( Vertex2D& v ) {
+    parallelForEach( vb, [&transform]( Vertex2D& v ) {
         v.position = transform * glm::vec3 { v.position, 1.0f };
     } );
 
-    auto range = std::views::iota( 0, static_cast<int>( vb.size() / 4 ) );
-    std::for_each( std::execution::par_unseq, range.begin(), range.end(), [this, image, &blendMode, &vb]( int i ) {
+    // Rotated tiles are drawn as a single batch of quads.
+    if ( !isScaleTranslate( transform ) )
+    {
+        // When binning or recording, the tiles are sorted into screen tiles like a batch of primitives,
+        // so each screen tile only replays the tiles of the map that overlap it.
+        if ( isBinning() || isRecording() )
+        {
+            auto positions = std::make_shared<const std::vector<glm::ivec2>>( snapPositions( vb ) );
+            auto vertices  = std::make_shared<const std::vector<Vertex2D>>( std::move( vb ) );
+
+            std::vector<glm::ivec4> bounds;
+            bounds.reserve( vertices->size() / 4 );
+            for ( size_t i = 0; i + 4 <= vertices->size(); i += 4 )
+            {
+                const AABB aabb = batchAABB( std::span( *vertices ).subspan( i, 4 ) );
+                bounds.emplace_back( std::floor( aabb.min.x ), std::floor( aabb.min.y ), std::ceil( aabb.max.x ), std::ceil( aabb.max.y ) );
+            }
+
+            drawBatch( bounds, [image, blendMode, vertices, positions]( const Rasterizer& rasterizer, std::span<const uint32_t> indices ) {
+                image->resolveClear();
+
+                auto index = [indices]( size_t i ) {
+                    return indices[i / 4] * 4 + static_cast<uint32_t>( i % 4 );
+                };
+
+                for ( const QuadSetup& setup: setupQuads( *vertices, indices.size(), index, rasterizer.state, rasterizer.getClipAABB() ) )
+                {
+                    const uint32_t first   = indices[setup.quad] * 4;
+                    const uint32_t quad[4] = { first, first + 1, first + 2, first + 3 };
+
+                    rasterizeQuad( *rasterizer.state.colorTarget, *vertices, *positions, quad, setup, *image, SamplerState {}, blendMode );
+                }
+            } );
+
+            return;
+        }
+
+        Image* dstImage = state.colorTarget;
+        if ( !dstImage )
+            return;
+
+        image->resolveClear();
+        beginWrite( *dstImage, getClipAABB().clamped( batchAABB( vb ) ) );
+
+        // The tiles are culled and clipped in SIMD batches, and the tiles that survive are rasterized in parallel.
+        const std::vector<glm::ivec2> positions = snapPositions( vb );
+        const std::vector<QuadSetup>  quads     = setupQuads( vb, vb.size() / 4, []( size_t i ) { return static_cast<uint32_t>( i ); }, state, getClipAABB() );
+
+        parallelForEach( quads, [&]( const QuadSetup& setup ) {
+            const uint32_t first   = setup.quad * 4;
+            const uint32_t quad[4] = { first, first + 1, first + 2, first + 3 };
+
+            rasterizeQuad( *dstImage, vb, positions, quad, setup, *image, SamplerState {}, blendMode );
+        } );
+
+        return;
+    }
+
+    // If the matrix only scales (or flips) and translates, the tiles are drawn as scaled blits.
+    auto range    = std::views::iota( 0, static_cast<int>( vb.size() / 4 ) );
+    auto drawTile = [this, image, &blendMode, &vb]( int i ) {
         const auto& v0 = vb[i * 4 + 0];
-        const auto& v1 = vb[i * 4 + 1];
         const auto& v2 = vb[i * 4 + 2];
-        const auto& v3 = vb[i * 4 + 3];
 
-        drawQuad( v0, v1, v2, v3, *image, SamplerState {}, blendMode );
-    } );
+        drawScaled( *image, v0.position, v2.position, v0.texCoord, v2.texCoord, v0.color, blendMode );
+    };
+
+    forEachDrawCall( range, drawTile );
 #else
     int rows    = static_cast<int>( tileMap.getRows() );
     int columns = static_cast<int>( tileMap.getColumns() );
@@ -1017,4 +3095,4 @@ void Rasterizer::drawTileMap( const TileMap& tileMap, const glm::mat3& transform
     }
 
 #endif
-}
\ No newline at end of file
+}
\ No newline at end of file
@@ -0,0 +1,33 @@
+#include <graphics/Task.hpp>
+#include <graphics/TaskScheduler.hpp>
+
+using namespace sr::graphics;
+
+Task::~Task()
+{
+    TaskScheduler::cancel( *this );
+
+    if ( m_Handle )
+        m_Handle.destroy();
+}
+
+Task::Task( Task&& other ) noexcept
+: m_Handle { std::exchange( other.m_Handle, nullptr ) }
+{
+    TaskScheduler::replace( other, *this );
+}
+
+Task& Task::operator=( Task&& other ) noexcept
+{
+    if ( this != &other )
+    {
+        TaskScheduler::cancel( *this );
+
+        if ( m_Handle )
+            m_Handle.destroy();
+        m_Handle = std::exchange( other.m_Handle, nullptr );
+
+        TaskScheduler::replace( other, *this );
+    }
+    return *this;
+}
@@ -0,0 +1,130 @@
+#include <graphics/Task.hpp>
+#include <graphics/TaskScheduler.hpp>
+
+#include <algorithm>
+#include <deque>
+
+using namespace sr::graphics;
+
+namespace
+{
+struct Scheduler
+{
+    std::deque<Task*>         queue;                                   ///< The scheduled tasks, in the order they are resumed.
+    Task*                     current = nullptr;                       ///< The task that is being resumed (it is not in the queue).
+    std::chrono::microseconds budget  = TaskScheduler::DefaultBudget;  ///< The time budget per frame.
+    TaskScheduler::Statistics statistics;                              ///< The statistics of the last update.
+};
+
+Scheduler& scheduler()
+{
+    // The scheduler is never destroyed, so tasks with static storage duration can still remove themselves when they are destroyed.
+    static Scheduler* s = new Scheduler;
+    return *s;
+}
+}  // namespace
+
+void TaskScheduler::schedule( Task& task )
+{
+    if ( !task || isScheduled( task ) )
+        return;
+
+    scheduler().queue.push_back( &task );
+}
+
+void TaskScheduler::cancel( const Task& task ) noexcept
+{
+    Scheduler& s = scheduler();
+
+    if ( s.current == &task )
+    {
+        s.current = nullptr;
+        return;
+    }
+
+    std::erase( s.queue, &task );
+}
+
+void TaskScheduler::replace( const Task& from, Task& to ) noexcept
+{
+    Scheduler& s = scheduler();
+
+    if ( s.current == &from )
+    {
+        s.current = &to;
+        return;
+    }
+
+    std::ranges::replace( s.queue, &from, &to );
+}
+
+bool TaskScheduler::isScheduled( const Task& task ) noexcept
+{
+    const Scheduler& s = scheduler();
+    return s.current == &task || std::ranges::find( s.queue, &task ) != s.queue.end();
+}
+
+const TaskScheduler::Statistics& TaskScheduler::update( std::chrono::microseconds budget )
+{
+    using clock = std::chrono::steady_clock;
+
+    Scheduler& s = scheduler();
+
+    const auto start = clock::now();
+
+    Statistics statistics;
+
+    // Resume the tasks in turn, so a long task doesn't starve the others.
+    // Tasks that are scheduled during the update are resumed in the same update (if there is time left).
+    while ( !s.queue.empty() && clock::now() - start < budget )
+    {
+        s.current = s.queue.front();
+        s.queue.pop_front();
+
+        s.current->resume();
+        ++statistics.resumed;
+
+        // The task may have been canceled (or destroyed) while it was running.
+        if ( s.current )
+        {
+            if ( *s.current )
+                s.queue.push_back( s.current );
+            else
+                ++statistics.completed;
+        }
+
+        s.current = nullptr;
+    }
+
+    statistics.queueDepth = s.queue.size();
+    statistics.timeSpent  = std::chrono::duration_cast<std::chrono::microseconds>( clock::now() - start );
+
+    s.statistics = statistics;
+
+    return s.statistics;
+}
+
+const TaskScheduler::Statistics& TaskScheduler::update()
+{
+    return update( scheduler().budget );
+}
+
+void TaskScheduler::setBudget( std::chrono::microseconds budget ) noexcept
+{
+    scheduler().budget = budget;
+}
+
+std::chrono::microseconds TaskScheduler::getBudget() noexcept
+{
+    return scheduler().budget;
+}
+
+std::size_t TaskScheduler::getQueueDepth() noexcept
+{
+    return scheduler().queue.size();
+}
+
+const TaskScheduler::Statistics& TaskScheduler::getStatistics() noexcept
+{
+    return scheduler().statistics;
+}
@@ -2,14 +2,21 @@
 
 #include "graphics/Rasterizer.hpp"
 #include "graphics/ResourceManager.hpp"
+#include "graphics/TaskScheduler.hpp"
+
+#include "TextFilters.hpp"
 
 #include <SDL_ttf_context.hpp>
 
 #include <SDL3_ttf/SDL_ttf.h>
 
 #include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <cstring>  // For std::memcpy
 #include <iostream>
 #include <utility>
+#include <vector>
 
 using namespace sr::graphics;
 
@@ -133,8 +140,12 @@ Text::Text( const Text& copy )
 : Text( copy.getFont(), copy.getText(), copy.getFillColor(), copy.getOutlineColor() )
 {}
 
-Text::Text( Text&& ) noexcept = default;
-Text::~Text()                 = default;
+Text::Text( Text&& other ) noexcept
+{
+    *this = std::move( other );
+}
+
+Text::~Text() = default;
 
 Text& Text::operator=( const Text& other )
 {
@@ -166,7 +177,30 @@ Text& Text::operator=( const Text& other )
     return *this;
 }
 
-Text& Text::operator=( Text&& ) noexcept = default;
+Text& Text::operator=( Text&& other ) noexcept
+{
+    if ( &other == this )
+        return *this;
+
+    // A scheduled update renders the text object that started it (the coroutine refers to it), so the updates
+    // of both texts are discarded, and both are re-rendered the next time their image is requested.
+    m_UpdateTask       = Task {};
+    other.m_UpdateTask = Task {};
+
+    m_Font = std::move( other.m_Font );
+    std::ranges::move( other.m_Text, std::begin( m_Text ) );
+
+    m_ShadowOffset  = other.m_ShadowOffset;
+    m_GlowRadius    = other.m_GlowRadius;
+    m_FontHash      = other.m_FontHash;
+    m_CachedImage   = std::move( other.m_CachedImage );
+    m_CachedPadding = other.m_CachedPadding;
+
+    m_IsDirty       = true;
+    other.m_IsDirty = true;
+
+    return *this;
+}
 
 Text& Text::operator=( std::string_view string )
 {
@@ -445,12 +479,18 @@ Text& Text::setWrapWidth( int width )
     return *this;
 }
 
-Task Text::updateCachedSurface() const
+Task Text::updateCachedImage() const
 {
     int        padding  = std::max( { m_Font->getOutline(), m_GlowRadius, std::abs( m_ShadowOffset.x ), std::abs( m_ShadowOffset.y ) } );
     glm::ivec2 textSize = glm::clamp( getFillSize() + ( padding * 2 ), { 1, 1 }, { 8192, 8192 } );
 
     SurfacePtr surface { SDL_CreateSurface( textSize.x, textSize.y, SDL_PIXELFORMAT_RGBA32 ) };
+    if ( !surface )
+    {
+        std::cerr << "Failed to create text surface: " << SDL_GetError() << std::endl;
+        co_return;
+    }
+
     // Clear the surface with the font's fill color to avoid the "transparent black" halo effect.
     Color fillColor      = getFillColor();
     fillColor.channels.a = 0;  // Start with a fully transparent color to clear the surface.
@@ -472,7 +512,7 @@ Task Text::updateCachedSurface() const
     if ( m_GlowRadius > 0 )
     {
         // Render the glow text once to a temporary surface.
-        glm::ivec2 glowSize = getSize( m_Text[Glow] );
+        glm::ivec2 glowSize = glm::max( getSize( m_Text[Glow] ), glm::ivec2 { 1, 1 } );
         SurfacePtr glowText { SDL_CreateSurface( glowSize.x, glowSize.y, SDL_PIXELFORMAT_RGBA32 ) };
         Color      glowClear = getGlowColor();
         glowClear.channels.a = 0;
@@ -482,25 +522,52 @@ Task Text::updateCachedSurface() const
             std::cerr << "Failed to draw glow text to temporary surface: " << SDL_GetError() << std::endl;
         }
 
-        // Blit the glow text at each offset onto the surface.
-        for ( int dy = -m_GlowRadius; dy <= m_GlowRadius; ++dy )
+        // The glow is the alpha of the glow text, dilated and blurred by the glow radius.
+        // Both filters are separable and cost the same per pixel for any radius.
+        // The glow is dilated first, and the blur softens the edge and rounds the corners of the dilated glow.
+        const int blurRadius   = std::min( m_GlowRadius / 2, detail::MaxBlurRadius );
+        const int dilateRadius = m_GlowRadius - blurRadius;
+        const int glowWidth    = glowText->w + m_GlowRadius * 2;
+        const int glowHeight   = glowText->h + m_GlowRadius * 2;
+
+        std::vector<uint8_t> alpha( static_cast<size_t>( glowWidth ) * glowHeight, 0 );
+        for ( int y = 0; y < glowText->h; ++y )
         {
-            for ( int dx = -m_GlowRadius; dx <= m_GlowRadius; ++dx )
+            const auto* src = static_cast<const Color*>( glowText->pixels ) + static_cast<size_t>( y ) * ( glowText->pitch / sizeof( Color ) );
+            uint8_t*    dst = alpha.data() + static_cast<size_t>( y + m_GlowRadius ) * glowWidth + m_GlowRadius;
+            for ( int x = 0; x < glowText->w; ++x )
+                dst[x] = src[x].channels.a;
+        }
+
+        detail::filterSeparable( alpha, glowWidth, glowHeight, dilateRadius, detail::dilateColumns );
+        detail::filterSeparable( alpha, glowWidth, glowHeight, blurRadius, detail::blurColumns );
+
+        co_yield nullptr;
+
+        // Blend the glow onto the surface with the glow color.
+        SurfacePtr glow { SDL_CreateSurface( glowWidth, glowHeight, SDL_PIXELFORMAT_RGBA32 ) };
+        if ( glow )
+        {
+            const Color glowColor = getGlowColor();
+            for ( int y = 0; y < glowHeight; ++y )
             {
-                if ( dx == 0 && dy == 0 )
-                    continue;
-
-                if ( ( dx * dx + dy * dy ) <= ( m_GlowRadius * m_GlowRadius ) )
-                {
-                    SDL_Rect dst { dx + padding, dy + padding, glowText->w, glowText->h };
-                    if ( !SDL_BlitSurface( glowText.get(), nullptr, surface.get(), &dst ) )
-                    {
-                        std::cerr << "Failed to blit glow text to surface: " << SDL_GetError() << std::endl;
-                    }
-                }
+                auto*          dst = static_cast<Color*>( glow->pixels ) + static_cast<size_t>( y ) * ( glow->pitch / sizeof( Color ) );
+                const uint8_t* src = alpha.data() + static_cast<size_t>( y ) * glowWidth;
+                for ( int x = 0; x < glowWidth; ++x )
+                    dst[x] = Color { glowColor.channels.r, glowColor.channels.g, glowColor.channels.b, src[x] };
             }
-            co_yield nullptr;
+
+            SDL_Rect dst { padding - m_GlowRadius, padding - m_GlowRadius, glowWidth, glowHeight };
+            if ( !SDL_BlitSurface( glow.get(), nullptr, surface.get(), &dst ) )
+            {
+                std::cerr << "Failed to blit glow to surface: " << SDL_GetError() << std::endl;
+            }
+        }
+        else
+        {
+            std::cerr << "Failed to create glow surface: " << SDL_GetError() << std::endl;
         }
+        co_yield nullptr;
     }
 
     // Draw the outline.
@@ -520,15 +587,23 @@ Task Text::updateCachedSurface() const
         std::cerr << "Failed to draw text fill to the surface: " << SDL_GetError() << std::endl;
     }
 
-    // Swap the finished surface and padding into the cache.
-    m_CachedSurface = std::move( surface );
+    // Copy the finished surface into a new image, and swap the image and padding into the cache.
+    // Draw calls that still reference the previous image keep it alive.
+    auto image = std::make_shared<Image>( surface->w, surface->h );
+    for ( int y = 0; y < surface->h; ++y )
+    {
+        const auto* src = static_cast<const std::byte*>( surface->pixels ) + static_cast<size_t>( y ) * surface->pitch;
+        std::memcpy( image->data() + static_cast<size_t>( y ) * surface->w, src, static_cast<size_t>( surface->w ) * sizeof( Color ) );
+    }
+
+    m_CachedImage   = std::move( image );
     m_CachedPadding = padding;
 }
 
-void Text::draw( Image& image, int x, int y ) const
+std::shared_ptr<const Image> Text::getImage() const
 {
-    if ( !image || !m_Font )
-        return;
+    if ( !m_Font )
+        return nullptr;
 
     static std::hash<Font> fontHasher;
     size_t                 fontHash = fontHasher( *m_Font );
@@ -536,31 +611,27 @@ void Text::draw( Image& image, int x, int y ) const
     {
         m_FontHash = fontHash;
         m_IsDirty  = false;
-        // Start the coroutine to update the cached surface over multiple frames.
-        m_UpdateTask = updateCachedSurface();
+        // Start the coroutine to update the cached image over multiple frames.
+        // The scheduler resumes it in the idle time of each frame (see TaskScheduler).
+        m_UpdateTask = updateCachedImage();
+        TaskScheduler::schedule( m_UpdateTask );
     }
 
-    // Resume the coroutine to do some work this frame.
-    if ( m_UpdateTask )
-    {
-        m_UpdateTask.resume();
-    }
+    return m_CachedImage;
+}
 
-    if ( m_CachedSurface )
-    {
-        // Create a surface from the image.
-        SurfacePtr surface = SurfacePtr { SDL_CreateSurfaceFrom( image.getWidth(), image.getHeight(), SDL_PIXELFORMAT_RGBA32, image.data(), image.getPitch() ) };
-        if ( !surface )
-        {
-            std::cerr << "Failed to create surface from image: " << SDL_GetError() << std::endl;
-            return;
-        }
+int Text::getImagePadding() const
+{
+    return m_CachedPadding;
+}
 
-        // Copy the cached surface to the image's surface.
-        SDL_Rect dstRect { x - m_CachedPadding, y - m_CachedPadding, m_CachedSurface->w, m_CachedSurface->h };
-        if ( !SDL_BlitSurface( m_CachedSurface.get(), nullptr, surface.get(), &dstRect ) )
-        {
-            std::cerr << "Failed to blit cached surface to image surface: " << SDL_GetError() << std::endl;
-        }
-    }
+void Text::draw( Image& image, int x, int y ) const
+{
+    if ( !image )
+        return;
+
+    Rasterizer rasterizer;
+    rasterizer.state.colorTarget = &image;
+    rasterizer.state.blendMode   = BlendMode::AlphaBlend;
+    rasterizer.drawText( *this, x, y );
 }
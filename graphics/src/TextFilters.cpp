@@ -0,0 +1,182 @@
+#include "TextFilters.hpp"
+
+#include <math/Intrinsics.hpp>
+
+#include <algorithm>
+#include <cassert>
+#include <cstring>  // For std::memcpy
+
+namespace
+{
+// dst[i] = max( a[i], b[i] )
+void maxRow( const uint8_t* a, const uint8_t* b, uint8_t* dst, int n )
+{
+    int i = 0;
+
+#if defined( SR_SIMD_SSE2 )
+    for ( ; i + 16 <= n; i += 16 )
+    {
+        const __m128i va = _mm_loadu_si128( reinterpret_cast<const __m128i*>( a + i ) );
+        const __m128i vb = _mm_loadu_si128( reinterpret_cast<const __m128i*>( b + i ) );
+        _mm_storeu_si128( reinterpret_cast<__m128i*>( dst + i ), _mm_max_epu8( va, vb ) );
+    }
+#elif defined( SR_SIMD_NEON )
+    for ( ; i + 16 <= n; i += 16 )
+    {
+        vst1q_u8( dst + i, vmaxq_u8( vld1q_u8( a + i ), vld1q_u8( b + i ) ) );
+    }
+#endif
+
+    for ( ; i < n; ++i )
+        dst[i] = std::max( a[i], b[i] );
+}
+}  // namespace
+
+namespace sr::graphics::detail
+{
+void transpose( const uint8_t* src, uint8_t* dst, int width, int height )
+{
+    // Transpose in blocks, so both the source and destination stay in the cache.
+    constexpr int BlockSize = 32;
+
+    for ( int by = 0; by < height; by += BlockSize )
+    {
+        for ( int bx = 0; bx < width; bx += BlockSize )
+        {
+            const int maxY = std::min( by + BlockSize, height );
+            const int maxX = std::min( bx + BlockSize, width );
+
+            for ( int y = by; y < maxY; ++y )
+            {
+                for ( int x = bx; x < maxX; ++x )
+                    dst[static_cast<size_t>( x ) * height + y] = src[static_cast<size_t>( y ) * width + x];
+            }
+        }
+    }
+}
+
+// This is the van Herk/Gil-Werman algorithm: the rows are split into blocks the size of the window,
+// and each window is the maximum of a suffix of one block and a prefix of the next block.
+void dilateColumns( std::vector<uint8_t>& image, int width, int height, int radius )
+{
+    if ( radius <= 0 )
+        return;
+
+    const int    windowSize = radius * 2 + 1;
+    const int    rows       = height + radius * 2;  // Padded with empty rows at the top and bottom.
+    const size_t rowSize    = static_cast<size_t>( width );
+
+    auto row = [&]( std::vector<uint8_t>& v, int y ) { return v.data() + y * rowSize; };
+
+    std::vector<uint8_t> padded( rows * rowSize, 0 );
+    std::memcpy( row( padded, radius ), image.data(), image.size() );
+
+    // The running maximum from the start of each block (prefix) and to the end of each block (suffix).
+    std::vector<uint8_t> prefix( padded.size() );
+    std::vector<uint8_t> suffix( padded.size() );
+
+    for ( int y = 0; y < rows; ++y )
+    {
+        if ( y % windowSize == 0 )
+            std::memcpy( row( prefix, y ), row( padded, y ), rowSize );
+        else
+            maxRow( row( prefix, y - 1 ), row( padded, y ), row( prefix, y ), width );
+    }
+
+    for ( int y = rows - 1; y >= 0; --y )
+    {
+        if ( y % windowSize == windowSize - 1 || y == rows - 1 )
+            std::memcpy( row( suffix, y ), row( padded, y ), rowSize );
+        else
+            maxRow( row( suffix, y + 1 ), row( padded, y ), row( suffix, y ), width );
+    }
+
+    // The window of pixel y is [y, y + 2 * radius] in the padded image.
+    for ( int y = 0; y < height; ++y )
+        maxRow( row( suffix, y ), row( prefix, y + radius * 2 ), row( image, y ), width );
+}
+
+// The sums of the windows are updated incrementally, so the cost per pixel is the same for any radius.
+void blurColumns( std::vector<uint8_t>& image, int width, int height, int radius )
+{
+    if ( radius <= 0 )
+        return;
+
+    assert( radius <= MaxBlurRadius );
+
+    const int windowSize = radius * 2 + 1;
+
+    // The sum of a window is at most 255 * 255, so it fits in 16 bits.
+    // The average is computed with a fixed-point reciprocal of the window size.
+    const uint16_t reciprocal = static_cast<uint16_t>( ( 65536 + windowSize - 1 ) / windowSize );
+
+    std::vector<uint8_t>  source = image;
+    std::vector<uint16_t> sums( width, 0 );
+
+    auto sourceRow = [&]( int y ) { return source.data() + static_cast<size_t>( y ) * width; };
+
+    // The sums of the windows of the first row (rows outside the image are empty).
+    for ( int y = 0; y < std::min( radius, height ); ++y )
+    {
+        const uint8_t* src = sourceRow( y );
+        for ( int x = 0; x < width; ++x )
+            sums[x] += src[x];
+    }
+
+    for ( int y = 0; y < height; ++y )
+    {
+        // Add the row that enters the window, and subtract the row that leaves the window (if they are inside the image).
+        const uint8_t* add = y + radius < height ? sourceRow( y + radius ) : nullptr;
+        const uint8_t* sub = y - radius - 1 >= 0 ? sourceRow( y - radius - 1 ) : nullptr;
+        uint8_t*       dst = image.data() + static_cast<size_t>( y ) * width;
+
+        int x = 0;
+
+#if defined( SR_SIMD_SSE2 )
+        const __m128i zero = _mm_setzero_si128();
+        const __m128i r    = _mm_set1_epi16( static_cast<short>( reciprocal ) );
+        for ( ; x + 8 <= width; x += 8 )
+        {
+            __m128i s = _mm_loadu_si128( reinterpret_cast<const __m128i*>( sums.data() + x ) );
+            if ( add )
+                s = _mm_add_epi16( s, _mm_unpacklo_epi8( _mm_loadl_epi64( reinterpret_cast<const __m128i*>( add + x ) ), zero ) );
+            if ( sub )
+                s = _mm_sub_epi16( s, _mm_unpacklo_epi8( _mm_loadl_epi64( reinterpret_cast<const __m128i*>( sub + x ) ), zero ) );
+            _mm_storeu_si128( reinterpret_cast<__m128i*>( sums.data() + x ), s );
+
+            // The average is saturated, in case it is rounded up to 256.
+            const __m128i average = _mm_mulhi_epu16( s, r );
+            _mm_storel_epi64( reinterpret_cast<__m128i*>( dst + x ), _mm_packus_epi16( average, zero ) );
+        }
+#elif defined( SR_SIMD_NEON )
+        const uint16x8_t r = vdupq_n_u16( reciprocal );
+        for ( ; x + 8 <= width; x += 8 )
+        {
+            uint16x8_t s = vld1q_u16( sums.data() + x );
+            if ( add )
+                s = vaddw_u8( s, vld1_u8( add + x ) );
+            if ( sub )
+                s = vsubw_u8( s, vld1_u8( sub + x ) );
+            vst1q_u16( sums.data() + x, s );
+
+            // The high half of the 32-bit products, saturated in case the average is rounded up to 256.
+            const uint32x4_t lo      = vmull_u16( vget_low_u16( s ), vget_low_u16( r ) );
+            const uint32x4_t hi      = vmull_u16( vget_high_u16( s ), vget_high_u16( r ) );
+            const uint16x8_t average = vcombine_u16( vshrn_n_u32( lo, 16 ), vshrn_n_u32( hi, 16 ) );
+            vst1_u8( dst + x, vqmovn_u16( average ) );
+        }
+#endif
+
+        for ( ; x < width; ++x )
+        {
+            if ( add )
+                sums[x] += add[x];
+            if ( sub )
+                sums[x] -= sub[x];
+
+            dst[x] = static_cast<uint8_t>( std::min( ( static_cast<uint32_t>( sums[x] ) * reciprocal ) >> 16, 255u ) );
+        }
+    }
+}
+
+}  // namespace sr::graphics::detail
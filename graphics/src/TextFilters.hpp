@@ -0,0 +1,60 @@
+#pragma once
+
+// The 8-bit filters that are used to render the glow of a Text.
+// They only process columns (each row is processed as a whole, so it can use SIMD). Rows are processed by transposing the image.
+
+#include <cstdint>
+#include <vector>
+
+namespace sr
+{
+inline namespace graphics
+{
+namespace detail
+{
+/// <summary>
+/// The maximum radius of blurColumns.
+/// </summary>
+constexpr int MaxBlurRadius = 127;
+
+/// <summary>
+/// Transpose an 8-bit image.
+/// </summary>
+/// <param name="src">The pixels of the image (width * height).</param>
+/// <param name="dst">The pixels of the transposed image (height * width).</param>
+/// <param name="width">The width of the source image.</param>
+/// <param name="height">The height of the source image.</param>
+void transpose( const uint8_t* src, uint8_t* dst, int width, int height );
+
+/// <summary>
+/// Dilate the columns of an 8-bit image with a window of 2 * radius + 1 pixels.
+/// Each pixel is replaced by the maximum of the window that is centered on it (pixels outside of the image are 0).
+/// </summary>
+void dilateColumns( std::vector<uint8_t>& image, int width, int height, int radius );
+
+/// <summary>
+/// Blur the columns of an 8-bit image with a box filter of 2 * radius + 1 pixels (radius <= MaxBlurRadius).
+/// Each pixel is replaced by the average of the window that is centered on it (pixels outside of the image are 0).
+/// </summary>
+void blurColumns( std::vector<uint8_t>& image, int width, int height, int radius );
+
+/// <summary>
+/// Apply a separable filter to the columns and then to the rows of an 8-bit image.
+/// </summary>
+template<typename Filter>
+void filterSeparable( std::vector<uint8_t>& image, int width, int height, int radius, Filter&& filter )
+{
+    if ( radius <= 0 )
+        return;
+
+    std::vector<uint8_t> transposed( image.size() );
+
+    filter( image, width, height, radius );
+    transpose( image.data(), transposed.data(), width, height );
+    filter( transposed, height, width, radius );
+    transpose( transposed.data(), image.data(), height, width );
+}
+
+}  // namespace detail
+}  // namespace graphics
+}  // namespace sr
@@ -0,0 +1,274 @@
+#include <graphics/ThreadPool.hpp>
+
+#include <cstdlib>
+#include <iostream>
+#include <string>
+
+using namespace sr::graphics;
+
+namespace
+{
+// The thread pool and queue of the calling thread (if it is a worker thread).
+thread_local const ThreadPool* t_Pool  = nullptr;
+thread_local size_t            t_Queue = 0;
+
+struct GlobalPool
+{
+    std::mutex                  mutex;
+    std::unique_ptr<ThreadPool> pool;
+};
+
+GlobalPool& globalPool()
+{
+    static GlobalPool globalPool;
+    return globalPool;
+}
+}  // namespace
+
+ThreadPool::ThreadPool( unsigned threadCount )
+{
+    const unsigned workerCount = std::max( threadCount, 1u ) - 1;
+
+    // One queue per worker, and the shared queue.
+    for ( unsigned i = 0; i <= workerCount; ++i )
+        m_Queues.push_back( std::make_unique<Queue>() );
+
+    for ( unsigned i = 0; i < workerCount; ++i )
+        m_Threads.emplace_back( &ThreadPool::run, this, i );
+}
+
+ThreadPool::~ThreadPool()
+{
+    // Run the jobs that were not picked up by a worker yet.
+    while ( runPendingJob() )
+        ;
+
+    {
+        std::lock_guard lock( m_Mutex );
+        m_Stop = true;
+    }
+    m_Condition.notify_all();
+
+    for ( std::thread& thread: m_Threads )
+        thread.join();
+}
+
+ThreadPool& ThreadPool::get()
+{
+    GlobalPool& global = globalPool();
+
+    std::lock_guard lock( global.mutex );
+    if ( !global.pool )
+        global.pool = std::make_unique<ThreadPool>();
+
+    return *global.pool;
+}
+
+void ThreadPool::setThreadCount( unsigned threadCount )
+{
+    GlobalPool& global = globalPool();
+
+    std::lock_guard lock( global.mutex );
+    global.pool.reset();
+    global.pool = std::make_unique<ThreadPool>( threadCount );
+}
+
+unsigned ThreadPool::getDefaultThreadCount()
+{
+    if ( const char* env = std::getenv( "SR_NUM_THREADS" ) )
+    {
+        try
+        {
+            const int threadCount = std::stoi( env );
+            if ( threadCount > 0 )
+                return static_cast<unsigned>( threadCount );
+        }
+        catch ( const std::exception& )
+        {}
+
+        std::cerr << "Invalid value for SR_NUM_THREADS: " << env << std::endl;
+    }
+
+    return std::max( std::thread::hardware_concurrency(), 1u );
+}
+
+void ThreadPool::submit( Job job )
+{
+    // The job is counted before it is added to the queue, so the count never drops below 0.
+    ++m_Pending;
+
+    Queue& queue = *m_Queues[getQueueIndex()];
+    {
+        std::lock_guard lock( queue.mutex );
+        queue.jobs.push_back( std::move( job ) );
+    }
+
+    // Lock the mutex before notifying, so a worker that is about to sleep doesn't miss the job.
+    {
+        std::lock_guard lock( m_Mutex );
+    }
+    m_Condition.notify_one();
+}
+
+bool ThreadPool::runPendingJob()
+{
+    Job job;
+    if ( !takeJob( getQueueIndex(), job ) )
+        return false;
+
+    job();
+    return true;
+}
+
+void ThreadPool::run( size_t index )
+{
+    t_Pool  = this;
+    t_Queue = index;
+
+    Job job;
+    while ( true )
+    {
+        if ( takeJob( index, job ) )
+        {
+            job();
+            job = nullptr;
+            continue;
+        }
+
+        std::unique_lock lock( m_Mutex );
+        m_Condition.wait( lock, [this] { return m_Pending > 0 || m_Stop; } );
+
+        if ( m_Stop && m_Pending == 0 )
+            return;
+    }
+}
+
+size_t ThreadPool::getQueueIndex() const noexcept
+{
+    return t_Pool == this ? t_Queue : m_Queues.size() - 1;
+}
+
+bool ThreadPool::takeJob( size_t index, Job& job )
+{
+    if ( m_Pending == 0 )
+        return false;
+
+    // Take the most recent job from the own queue.
+    {
+        Queue& queue = *m_Queues[index];
+
+        std::lock_guard lock( queue.mutex );
+        if ( !queue.jobs.empty() )
+        {
+            job = std::move( queue.jobs.back() );
+            queue.jobs.pop_back();
+            --m_Pending;
+            return true;
+        }
+    }
+
+    // Steal the oldest job from another queue.
+    for ( size_t i = 1; i < m_Queues.size(); ++i )
+    {
+        Queue& queue = *m_Queues[( index + i ) % m_Queues.size()];
+
+        std::lock_guard lock( queue.mutex );
+        if ( !queue.jobs.empty() )
+        {
+            job = std::move( queue.jobs.front() );
+            queue.jobs.pop_front();
+            --m_Pending;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+TaskGroup::TaskGroup( ThreadPool& pool )
+: m_Pool { pool }
+{}
+
+TaskGroup::~TaskGroup()
+{
+    wait();
+}
+
+void TaskGroup::run( ThreadPool::Job job )
+{
+    {
+        std::lock_guard lock( m_Mutex );
+        ++m_Count;
+    }
+
+    m_Pool.submit( [this, job = std::move( job )] {
+        job();
+        finish();
+    } );
+}
+
+void TaskGroup::then( ThreadPool::Job continuation )
+{
+    {
+        std::lock_guard lock( m_Mutex );
+        if ( m_Count > 0 )
+        {
+            m_Continuations.push_back( std::move( continuation ) );
+            return;
+        }
+    }
+
+    run( std::move( continuation ) );
+}
+
+void TaskGroup::wait()
+{
+    // Help with the pending jobs until the jobs of the group are done.
+    while ( !isIdle() )
+    {
+        if ( m_Pool.runPendingJob() )
+            continue;
+
+        // The remaining jobs of the group are running on other threads.
+        std::unique_lock lock( m_Mutex );
+        m_Condition.wait( lock, [this] { return m_Count == 0; } );
+        return;
+    }
+}
+
+bool TaskGroup::isIdle() const
+{
+    std::lock_guard lock( m_Mutex );
+    return m_Count == 0;
+}
+
+void TaskGroup::finish()
+{
+    std::vector<ThreadPool::Job> continuations;
+    {
+        std::lock_guard lock( m_Mutex );
+
+        // The continuations become jobs of the group when the last job finishes.
+        if ( m_Count == 1 && !m_Continuations.empty() )
+        {
+            continuations = std::move( m_Continuations );
+            m_Continuations.clear();
+            m_Count += continuations.size();
+        }
+
+        // The group may be destroyed as soon as the mutex is unlocked, so waiting threads are notified with the mutex locked.
+        if ( --m_Count == 0 )
+        {
+            m_Condition.notify_all();
+            return;
+        }
+    }
+
+    for ( ThreadPool::Job& continuation: continuations )
+    {
+        m_Pool.submit( [this, continuation = std::move( continuation )] {
+            continuation();
+            finish();
+        } );
+    }
+}
@@ -1,6 +1,7 @@
 #include <graphics/Window.hpp>
 
 #include "graphics/ResourceManager.hpp"
+#include "graphics/TaskScheduler.hpp"
 
 #include <SDL3/SDL_init.h>
 #include <SDL3/SDL_log.h>
@@ -10,8 +11,12 @@
 #include <imgui_impl_sdl3.h>
 #include <imgui_impl_sdlrenderer3.h>
 
+#include <cassert>
+#include <cstddef>
+#include <cstring>  // for std::memcpy
 #include <stdexcept>
 #include <utility>  // for std::exchange
+#include <vector>
 
 using namespace sr;
 
@@ -33,6 +38,32 @@ struct SDL_Context
     }
 };
 
+// (Re)create a streaming texture if it doesn't exist or doesn't match the requested size.
+// Returns false if the texture could not be created.
+static bool resizeTexture( SDL_Renderer* renderer, SDL_Texture*& texture, int width, int height, bool* recreated = nullptr )
+{
+    float w, h;
+    if ( texture && SDL_GetTextureSize( texture, &w, &h ) && w == static_cast<float>( width ) && h == static_cast<float>( height ) )
+        return true;
+
+    if ( texture )
+        SDL_DestroyTexture( texture );
+
+    texture = SDL_CreateTexture( renderer, SDL_PIXELFORMAT_RGBA32, SDL_TEXTUREACCESS_STREAMING, width, height );
+    if ( !texture )
+    {
+        SDL_LogError( SDL_LOG_CATEGORY_APPLICATION, "Failed to create texture: %s", SDL_GetError() );
+        return false;
+    }
+    SDL_SetTextureScaleMode( texture, SDL_SCALEMODE_NEAREST );
+    SDL_SetTextureBlendMode( texture, SDL_BLENDMODE_NONE );
+
+    if ( recreated )
+        *recreated = true;
+
+    return true;
+}
+
 struct ImGui_Context
 {
     ImGui_Context()
@@ -74,6 +105,8 @@ struct ImGui_Context
 Window::~Window()
 {
     SDL_DestroyTexture( m_Texture );
+    for ( SDL_Texture* texture: m_FrameTextures )
+        SDL_DestroyTexture( texture );
     SDL_DestroyRenderer( m_Renderer );
     SDL_DestroyWindow( m_Window );
 }
@@ -87,6 +120,12 @@ Window::Window( Window&& window ) noexcept
 : m_Window( std::exchange( window.m_Window, nullptr ) )
 , m_Renderer( std::exchange( window.m_Renderer, nullptr ) )
 , m_Texture( std::exchange( window.m_Texture, nullptr ) )
+, m_PresentedImage( std::exchange( window.m_PresentedImage, nullptr ) )
+, m_FrameTextures { std::exchange( window.m_FrameTextures[0], nullptr ), std::exchange( window.m_FrameTextures[1], nullptr ) }
+, m_FrameIndex( std::exchange( window.m_FrameIndex, 0 ) )
+, m_FramePixels( std::exchange( window.m_FramePixels, nullptr ) )
+, m_FramePitch( std::exchange( window.m_FramePitch, 0 ) )
+, m_Frame( std::move( window.m_Frame ) )
 , m_Width( std::exchange( window.m_Width, -1 ) )
 , m_Height( std::exchange( window.m_Height, -1 ) )
 , m_Fullscreen( std::exchange( window.m_Fullscreen, false ) )
@@ -98,13 +137,20 @@ Window& Window::operator=( Window&& window ) noexcept
     if ( this == &window )
         return *this;
 
-    m_Window     = std::exchange( window.m_Window, nullptr );
-    m_Renderer   = std::exchange( window.m_Renderer, nullptr );
-    m_Texture    = std::exchange( window.m_Texture, nullptr );
-    m_Width      = std::exchange( window.m_Width, -1 );
-    m_Height     = std::exchange( window.m_Height, -1 );
-    m_Fullscreen = std::exchange( window.m_Fullscreen, false );
-    m_VSync      = std::exchange( window.m_VSync, true );
+    m_Window           = std::exchange( window.m_Window, nullptr );
+    m_Renderer         = std::exchange( window.m_Renderer, nullptr );
+    m_Texture          = std::exchange( window.m_Texture, nullptr );
+    m_PresentedImage   = std::exchange( window.m_PresentedImage, nullptr );
+    m_FrameTextures[0] = std::exchange( window.m_FrameTextures[0], nullptr );
+    m_FrameTextures[1] = std::exchange( window.m_FrameTextures[1], nullptr );
+    m_FrameIndex       = std::exchange( window.m_FrameIndex, 0 );
+    m_FramePixels      = std::exchange( window.m_FramePixels, nullptr );
+    m_FramePitch       = std::exchange( window.m_FramePitch, 0 );
+    m_Frame            = std::move( window.m_Frame );
+    m_Width            = std::exchange( window.m_Width, -1 );
+    m_Height           = std::exchange( window.m_Height, -1 );
+    m_Fullscreen       = std::exchange( window.m_Fullscreen, false );
+    m_VSync            = std::exchange( window.m_VSync, true );
 
     return *this;
 }
@@ -277,6 +323,9 @@ void Window::clear( const Color& color )
 
 void Window::present()
 {
+    // Resume background tasks until the time budget of the frame is used up.
+    TaskScheduler::update();
+
     // ImGui rendering
     ImGui::Render();
 
@@ -301,35 +350,137 @@ void Window::present( const Image& image )
     if ( !m_Window )
         return;
 
-    float w, h;
-    if ( !m_Texture || ( SDL_GetTextureSize( m_Texture, &w, &h ) && ( w != static_cast<float>( image.getWidth() ) || h != static_cast<float>( image.getHeight() ) ) ) )
+    // The frame was rendered directly into a streaming texture.
+    if ( m_FramePixels && &image == &m_Frame )
     {
-        if ( m_Texture )
-            SDL_DestroyTexture( m_Texture );
+        presentFrame();
+        return;
+    }
+
+    // The entire image is uploaded if the texture is (re)created, or if a different image was presented last.
+    bool fullUpload = m_PresentedImage != &image;
 
-        m_Texture = SDL_CreateTexture( m_Renderer, SDL_PIXELFORMAT_RGBA32, SDL_TEXTUREACCESS_STREAMING, image.getWidth(), image.getHeight() );
-        if ( !m_Texture )
+    if ( !resizeTexture( m_Renderer, m_Texture, image.getWidth(), image.getHeight(), &fullUpload ) )
+        return;
+
+    // Clear the tiles that were not drawn to since the last fast clear.
+    image.resolveClear();
+
+    // The dirty regions are always taken, so they only contain the changes since this image was last presented.
+    const std::vector<math::RectI> dirtyRects = image.takeDirtyRects();
+    m_PresentedImage                          = &image;
+
+    // Copy the image data to the texture.
+    if ( fullUpload )
+    {
+        if ( !SDL_UpdateTexture( m_Texture, nullptr, image.data(), static_cast<int>( image.getPitch() ) ) )
         {
-            SDL_LogError( SDL_LOG_CATEGORY_APPLICATION, "Failed to create texture: %s", SDL_GetError() );
+            SDL_LogError( SDL_LOG_CATEGORY_APPLICATION, "Failed to update texture: %s", SDL_GetError() );
+            m_PresentedImage = nullptr;
             return;
         }
-        SDL_SetTextureScaleMode( m_Texture, SDL_SCALEMODE_NEAREST );
-        SDL_SetTextureBlendMode( m_Texture, SDL_BLENDMODE_NONE );
+    }
+    else
+    {
+        // Only copy the regions of the image that changed since it was last presented.
+        for ( const math::RectI& rect: dirtyRects )
+        {
+            const SDL_Rect dstRect { rect.left, rect.top, rect.width, rect.height };
+            const Color*   src = image.data() + static_cast<size_t>( rect.top ) * image.getWidth() + rect.left;
+
+            if ( !SDL_UpdateTexture( m_Texture, &dstRect, src, static_cast<int>( image.getPitch() ) ) )
+            {
+                SDL_LogError( SDL_LOG_CATEGORY_APPLICATION, "Failed to update texture: %s", SDL_GetError() );
+                m_PresentedImage = nullptr;
+                return;
+            }
+        }
     }
 
-    // Copy the image data to the texture.
-    if ( !SDL_UpdateTexture( m_Texture, nullptr, image.data(), static_cast<int>( image.getPitch() ) ) )
+    presentTexture( m_Texture, image.getWidth(), image.getHeight() );
+}
+
+Image* Window::acquireFrame( int width, int height )
+{
+    if ( !m_Window )
+        return nullptr;
+
+    // The frame was already acquired.
+    if ( m_FramePixels )
     {
-        SDL_LogError( SDL_LOG_CATEGORY_APPLICATION, "Failed to update texture: %s", SDL_GetError() );
-        return;
+        assert( m_Frame.getWidth() == width && m_Frame.getHeight() == height );
+        return &m_Frame;
+    }
+
+    SDL_Texture*& texture = m_FrameTextures[m_FrameIndex];
+    if ( !resizeTexture( m_Renderer, texture, width, height ) )
+        return nullptr;
+
+    if ( !SDL_LockTexture( texture, nullptr, &m_FramePixels, &m_FramePitch ) )
+    {
+        SDL_LogError( SDL_LOG_CATEGORY_APPLICATION, "Failed to lock texture: %s", SDL_GetError() );
+        m_FramePixels = nullptr;
+        return nullptr;
+    }
+
+    if ( m_FramePitch == width * static_cast<int>( sizeof( Color ) ) )
+    {
+        // Render directly into the pixels of the texture.
+        // The pixels can move every time the texture is locked, but the bookkeeping of the view is reused if the size didn't change.
+        if ( m_Frame.isView() && m_Frame.getWidth() == width && m_Frame.getHeight() == height )
+            m_Frame.setView( static_cast<Color*>( m_FramePixels ) );
+        else
+            m_Frame = Image { static_cast<Color*>( m_FramePixels ), static_cast<uint32_t>( width ), static_cast<uint32_t>( height ) };
+    }
+    else
+    {
+        // The rows of the texture are padded, so the frame is rendered to an image that is copied to the texture in present.
+        if ( m_Frame.isView() )
+            m_Frame = Image {};
+
+        m_Frame.resize( static_cast<uint32_t>( width ), static_cast<uint32_t>( height ) );
     }
 
+    return &m_Frame;
+}
+
+void Window::presentFrame()
+{
+    SDL_Texture* texture = m_FrameTextures[m_FrameIndex];
+
+    // Clear the tiles that were not drawn to since the last fast clear.
+    m_Frame.resolveClear();
+
+    if ( !m_Frame.isView() )
+    {
+        const auto*  src      = reinterpret_cast<const std::byte*>( m_Frame.data() );
+        auto*        dst      = static_cast<std::byte*>( m_FramePixels );
+        const size_t rowBytes = static_cast<size_t>( m_Frame.getPitch() );
+
+        for ( int y = 0; y < m_Frame.getHeight(); ++y )
+            std::memcpy( dst + static_cast<size_t>( y ) * m_FramePitch, src + y * rowBytes, rowBytes );
+    }
+
+    // The entire texture is uploaded when it is unlocked, so the dirty regions are not needed.
+    m_Frame.takeDirtyRects();
+
+    SDL_UnlockTexture( texture );
+    m_FramePixels = nullptr;
+
+    // The next frame is rendered to the other texture, while this one is still being drawn.
+    m_FrameIndex ^= 1;
+
+    presentTexture( texture, m_Frame.getWidth(), m_Frame.getHeight() );
+}
+
+void Window::presentTexture( SDL_Texture* texture, int width, int height )
+{
     // Center the image on the screen while maintaining the aspect ratio.
     SDL_FRect dstRect {
         0.0f, 0.0f, static_cast<float>( m_Width ), static_cast<float>( m_Height )
     };
     SDL_FRect srcRect {
-        0.0f, 0.0f, static_cast<float>( image.getWidth() ), static_cast<float>( image.getHeight() )
+        0.0f, 0.0f, static_cast<float>( width ), static_cast<float>( height )
     };
 
     const float aspectRatio = srcRect.w / srcRect.h;
@@ -348,7 +499,7 @@ void Window::present( const Image& image )
     dstRect.x = ( static_cast<float>( m_Width ) - dstRect.w ) / 2;
     dstRect.y = ( static_cast<float>( m_Height ) - dstRect.h ) / 2;
 
-    if ( !SDL_RenderTexture( m_Renderer, m_Texture, &srcRect, &dstRect ) )
+    if ( !SDL_RenderTexture( m_Renderer, texture, &srcRect, &dstRect ) )
     {
         SDL_LogError( SDL_LOG_CATEGORY_APPLICATION, "Failed to render texture: %s", SDL_GetError() );
         return;
@@ -514,22 +514,22 @@ struct AABB
             float x = 0.0f, y = 0.0f;
 
             // Now find the intersection point.
-            if ( oc == OutCode::Top )  // Point is above the image.
+            if ( ( oc & OutCode::Top ) != 0 )  // Point is above the image.
             {
                 x = x0 + ( x1 - x0 ) * ( max.y - y0 ) / ( y1 - y0 );
                 y = max.y;
             }
-            else if ( oc == OutCode::Bottom )  // Point is below the image.
+            else if ( ( oc & OutCode::Bottom ) != 0 )  // Point is below the image.
             {
                 x = x0 + ( x1 - x0 ) * ( min.y - y0 ) / ( y1 - y0 );
                 y = min.y;
             }
-            else if ( oc == OutCode::Right )  // Point is to the right of the image.
+            else if ( ( oc & OutCode::Right ) != 0 )  // Point is to the right of the image.
             {
                 y = y0 + ( y1 - y0 ) * ( max.x - x0 ) / ( x1 - x0 );
                 x = max.x;
             }
-            else if ( oc == OutCode::Left )  // Point is to the left of the image.
+            else if ( ( oc & OutCode::Left ) != 0 )  // Point is to the left of the image.
             {
                 y = y0 + ( y1 - y0 ) * ( min.x - x0 ) / ( x1 - x0 );
                 x = min.x;
@@ -26,6 +26,11 @@
     #include <smmintrin.h>
 #endif
 
+#if defined( __AVX2__ )
+    #define SR_SIMD_AVX2 1
+    #include <immintrin.h>
+#endif
+
 #if defined( __ARM_NEON ) || defined( __ARM_NEON__ )
     #define SR_SIMD_NEON 1
     #include <arm_neon.h>
@@ -289,5 +294,76 @@ inline int count_trailing_zeros( int x ) noexcept
 #endif
 }
 
+// Compute the coverage mask of 8 horizontally adjacent pixels.
+// w contains the values of the 3 edge functions at the first pixel, and dY contains the
+// change of the edge functions for each step in x. Bit i of the result is set if
+// all 3 edge functions are non-negative at pixel i.
+inline int simd_edge_coverage_mask8( const int* w, const int* dY ) noexcept
+{
+#if defined( SR_SIMD_AVX2 )
+    const __m256i lane = _mm256_setr_epi32( 0, 1, 2, 3, 4, 5, 6, 7 );
+    __m256i       any  = _mm256_setzero_si256();
+
+    for ( int e = 0; e < 3; ++e )
+    {
+        __m256i weights = _mm256_add_epi32( _mm256_set1_epi32( w[e] ), _mm256_mullo_epi32( lane, _mm256_set1_epi32( dY[e] ) ) );
+        any             = _mm256_or_si256( any, weights );
+    }
+
+    // The sign bit of each lane is set if any of the weights is negative.
+    return ~_mm256_movemask_ps( _mm256_castsi256_ps( any ) ) & 0xFF;
+#elif defined( SR_SIMD_SSE2 )
+    __m128i any0 = _mm_setzero_si128();
+    __m128i any1 = _mm_setzero_si128();
+
+    for ( int e = 0; e < 3; ++e )
+    {
+        __m128i weights0 = _mm_setr_epi32( w[e], w[e] + dY[e], w[e] + 2 * dY[e], w[e] + 3 * dY[e] );
+        __m128i weights1 = _mm_add_epi32( weights0, _mm_set1_epi32( 4 * dY[e] ) );
+
+        any0 = _mm_or_si128( any0, weights0 );
+        any1 = _mm_or_si128( any1, weights1 );
+    }
+
+    // The sign bit of each lane is set if any of the weights is negative.
+    int outside = _mm_movemask_ps( _mm_castsi128_ps( any0 ) ) | ( _mm_movemask_ps( _mm_castsi128_ps( any1 ) ) << 4 );
+    return ~outside & 0xFF;
+#elif defined( SR_SIMD_NEON )
+    static const int32_t lanes[4] = { 0, 1, 2, 3 };
+
+    const int32x4_t lane = vld1q_s32( lanes );
+    int32x4_t       any0 = vdupq_n_s32( 0 );
+    int32x4_t       any1 = vdupq_n_s32( 0 );
+
+    for ( int e = 0; e < 3; ++e )
+    {
+        int32x4_t weights0 = vmlaq_n_s32( vdupq_n_s32( w[e] ), lane, dY[e] );
+        int32x4_t weights1 = vaddq_s32( weights0, vdupq_n_s32( 4 * dY[e] ) );
+
+        any0 = vorrq_s32( any0, weights0 );
+        any1 = vorrq_s32( any1, weights1 );
+    }
+
+    int32_t any[8];
+    vst1q_s32( any, any0 );
+    vst1q_s32( any + 4, any1 );
+
+    int mask = 0;
+    for ( int i = 0; i < 8; ++i )
+        mask |= ( any[i] >= 0 ) << i;
+
+    return mask;
+#else
+    int mask = 0;
+    for ( int i = 0; i < 8; ++i )
+    {
+        int any = ( w[0] + i * dY[0] ) | ( w[1] + i * dY[1] ) | ( w[2] + i * dY[2] );
+        mask |= ( any >= 0 ) << i;
+    }
+
+    return mask;
+#endif
+}
+
 }  // namespace math
 }  // namespace sr
\ No newline at end of file
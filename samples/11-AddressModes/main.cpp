@@ -8,7 +8,6 @@
 #include <imgui.h>
 
 #include <algorithm>
-#include <execution>
 #include <ranges>
 
 using namespace sr;
@@ -112,20 +111,27 @@ int main()
         const int tileSize = 16;
         const int tilesX   = ( w + tileSize - 1 ) / tileSize;
         const int tilesY   = ( h + tileSize - 1 ) / tileSize;
-        auto      range    = std::views::iota( 0, tilesY * tilesX );
-
-        std::for_each( std::execution::par_unseq, range.begin(), range.end(), [tilesX, &rasterizer, &verts, &texture, &samplerState]( int i ) {
-            const int x = i % tilesX;
-            const int y = i / tilesX;
-            auto      r = rasterizer;
-
-            r.state.viewport = Viewport {
-                static_cast<float>( x * tileSize ),
-                static_cast<float>( y * tileSize ),
-                tileSize, tileSize
-            };
-            r.drawQuad( verts[0], verts[1], verts[2], verts[3], texture, samplerState );
-        } );
+
+        // The binner already splits the screen into tiles, so the quad is drawn as a single draw call.
+        if ( rasterizer.isBinning() )
+        {
+            rasterizer.drawQuad( verts[0], verts[1], verts[2], verts[3], texture, samplerState );
+        }
+        else
+        {
+            rasterizer.forEachDrawCall( std::views::iota( 0, tilesY * tilesX ), [tilesX, &rasterizer, &verts, &texture, &samplerState]( int i ) {
+                const int x = i % tilesX;
+                const int y = i / tilesX;
+                auto      r = rasterizer;
+
+                r.state.viewport = Viewport {
+                    static_cast<float>( x * tileSize ),
+                    static_cast<float>( y * tileSize ),
+                    tileSize, tileSize
+                };
+                r.drawQuad( verts[0], verts[1], verts[2], verts[3], texture, samplerState );
+            } );
+        }
 
         //for ( int y = 0; y < tilesY; ++y )
         //{
@@ -5,7 +5,6 @@
 #include <graphics/ResourceManager.hpp>
 
 #include <algorithm>
-#include <execution>
 #include <ranges>
 
 using namespace sr;
@@ -57,15 +56,15 @@ void Background::draw( Rasterizer& rasterizer ) const
         }
     }
 
-    auto range = std::views::iota( 0, static_cast<int>( tileRows * tileColumns ) );
-
-    // Now render the quads in parallel.
-    std::for_each( std::execution::par_unseq, range.begin(), range.end(), [this, &rasterizer, &vertices]( int i ) {
+    auto drawTile = [this, &rasterizer, &vertices]( int i ) {
         const auto& v0 = vertices[i * 4 + 0];
         const auto& v1 = vertices[i * 4 + 1];
         const auto& v2 = vertices[i * 4 + 2];
         const auto& v3 = vertices[i * 4 + 3];
 
         rasterizer.drawQuad( v0, v1, v2, v3, *backgroundImage );
-    } );
+    };
+
+    // Now render the quads (in parallel in immediate mode).
+    rasterizer.forEachDrawCall( std::views::iota( 0, static_cast<int>( tileRows * tileColumns ) ), drawTile );
 }
@@ -21,6 +21,7 @@ Game::Game( uint32_t screenWidth, uint32_t screenHeight )
 
     rasterizer.state.colorTarget = &image;
     rasterizer.state.cullMode    = CullMode::None;  // Disable culling.
+    rasterizer.beginBinning();                      // Rasterize the frame in parallel screen tiles.
 
     // Input that controls the characters horizontal movement.
     Input::addAxisCallback( "Horizontal", []( std::span<const GamepadStateTracker> gamePadStates, const KeyboardStateTracker& keyboardState, const MouseStateTracker& mouseState ) {
@@ -231,6 +232,9 @@ void Game::update()
     }
 #endif
 
+    // Rasterize the binned draw calls before the image is presented.
+    rasterizer.flush();
+
     // timer.limitFPS( 5 );
 }
 
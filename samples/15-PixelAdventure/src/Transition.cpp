@@ -2,9 +2,6 @@
 
 #include <graphics/ResourceManager.hpp>
 
-#include <algorithm>
-#include <execution>
-
 using namespace sr;
 
 Transition::Transition( const std::filesystem::path& fileName )
@@ -63,7 +60,7 @@ void Transition::setRatio( float ratio )
 
 void Transition::draw( Rasterizer& rasterizer ) const
 {
-    std::for_each( std::execution::par_unseq, transforms.begin(), transforms.end(), [this, &rasterizer]( const Transform2D& transform ) {
+    rasterizer.forEachDrawCall( transforms, [this, &rasterizer]( const Transform2D& transform ) {
         rasterizer.drawSprite( sprite, transform );
     } );
 }
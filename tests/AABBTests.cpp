@@ -0,0 +1,118 @@
+#include <math/AABB.hpp>
+#include <gtest/gtest.h>
+
+#include <random>
+
+using namespace sr::math;
+
+namespace
+{
+// The clip rectangle of a 100x100 image.
+const AABB Clip = AABB::fromMinMax( { 0, 0, 0 }, { 99, 99, 0 } );
+
+// Tolerance for the clipped end points.
+constexpr float Epsilon = 1e-3f;
+
+// Check that a point lies on the line through (x0, y0) and (x1, y1).
+void expectOnLine( float x, float y, float x0, float y0, float x1, float y1 )
+{
+    const float dx = x1 - x0;
+    const float dy = y1 - y0;
+
+    EXPECT_NEAR( ( x - x0 ) * dy - ( y - y0 ) * dx, 0.0f, Epsilon * std::max( std::abs( dx ), std::abs( dy ) ) );
+}
+
+void expectInside( float x, float y )
+{
+    EXPECT_GE( x, Clip.min.x - Epsilon );
+    EXPECT_LE( x, Clip.max.x + Epsilon );
+    EXPECT_GE( y, Clip.min.y - Epsilon );
+    EXPECT_LE( y, Clip.max.y + Epsilon );
+}
+}  // namespace
+
+// A line that starts in a corner region (Top|Left) and ends inside of the rectangle is clipped to the rectangle.
+TEST(AABBClipTest, CornerRegionToInside)
+{
+    ASSERT_EQ( Clip.computeOutCode( -20.0f, 120.0f ), OutCode::Top | OutCode::Left );
+
+    float x0 = -20.0f, y0 = 120.0f, x1 = 50.0f, y1 = 50.0f;
+    ASSERT_TRUE( Clip.clip( x0, y0, x1, y1 ) );
+
+    expectInside( x0, y0 );
+    expectOnLine( x0, y0, -20.0f, 120.0f, 50.0f, 50.0f );
+    EXPECT_FLOAT_EQ( x1, 50.0f );
+    EXPECT_FLOAT_EQ( y1, 50.0f );
+}
+
+// A line from one corner region to the opposite corner region (Bottom|Right) is clipped at both ends.
+TEST(AABBClipTest, CornerRegionToCornerRegion)
+{
+    ASSERT_EQ( Clip.computeOutCode( 130.0f, -40.0f ), OutCode::Bottom | OutCode::Right );
+
+    float x0 = -20.0f, y0 = 120.0f, x1 = 130.0f, y1 = -40.0f;
+    ASSERT_TRUE( Clip.clip( x0, y0, x1, y1 ) );
+
+    expectInside( x0, y0 );
+    expectInside( x1, y1 );
+    expectOnLine( x0, y0, -20.0f, 120.0f, 130.0f, -40.0f );
+    expectOnLine( x1, y1, -20.0f, 120.0f, 130.0f, -40.0f );
+}
+
+// A line that starts in a corner region and passes above the rectangle is rejected.
+TEST(AABBClipTest, CornerRegionMiss)
+{
+    float x0 = -20.0f, y0 = 110.0f, x1 = 200.0f, y1 = 99.0f;
+    EXPECT_FALSE( Clip.clip( x0, y0, x1, y1 ) );
+
+    int ix0 = -20, iy0 = 110, ix1 = 200, iy1 = 99;
+    EXPECT_FALSE( Clip.clip( ix0, iy0, ix1, iy1 ) );
+}
+
+// The integer overload clips lines that start in a corner region.
+TEST(AABBClipTest, CornerRegionInt)
+{
+    int x0 = -30, y0 = -30, x1 = 60, y1 = 60;
+    ASSERT_TRUE( Clip.clip( x0, y0, x1, y1 ) );
+
+    EXPECT_EQ( x0, 0 );
+    EXPECT_EQ( y0, 0 );
+    EXPECT_EQ( x1, 60 );
+    EXPECT_EQ( y1, 60 );
+}
+
+// Every line that crosses the rectangle is accepted, and the clipped end points lie on the line, inside of the rectangle.
+TEST(AABBClipTest, RandomLines)
+{
+    std::mt19937                          rng( 11 );
+    std::uniform_real_distribution<float> dist( -150.0f, 250.0f );
+
+    for ( int i = 0; i < 10000; ++i )
+    {
+        const float ax = dist( rng ), ay = dist( rng ), bx = dist( rng ), by = dist( rng );
+
+        // Sample the line to find out if it crosses the rectangle.
+        bool crosses = false;
+        for ( int s = 0; s <= 256 && !crosses; ++s )
+        {
+            const float t = static_cast<float>( s ) / 256.0f;
+            crosses       = Clip.computeOutCode( ax + ( bx - ax ) * t, ay + ( by - ay ) * t ) == OutCode::Inside;
+        }
+
+        float x0 = ax, y0 = ay, x1 = bx, y1 = by;
+        const bool accepted = Clip.clip( x0, y0, x1, y1 );
+
+        if ( crosses )
+        {
+            ASSERT_TRUE( accepted ) << "(" << ax << ", " << ay << ") - (" << bx << ", " << by << ")";
+        }
+
+        if ( accepted )
+        {
+            expectInside( x0, y0 );
+            expectInside( x1, y1 );
+            expectOnLine( x0, y0, ax, ay, bx, by );
+            expectOnLine( x1, y1, ax, ay, bx, by );
+        }
+    }
+}
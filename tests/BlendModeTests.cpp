@@ -0,0 +1,113 @@
+#include <graphics/BlendMode.hpp>
+#include <gtest/gtest.h>
+
+#include <random>
+#include <vector>
+
+using namespace sr::graphics;
+
+namespace
+{
+// An odd number of pixels, so both the SIMD loop and the scalar tail are tested.
+constexpr size_t SpanSize = 37;
+
+std::vector<Color> randomColors( std::mt19937& rng, size_t n )
+{
+    std::vector<Color> colors( n );
+    for ( auto& c: colors )
+        c = Color( static_cast<uint32_t>( rng() ) );
+
+    return colors;
+}
+}  // namespace
+
+// blendSpan must produce the same result as Blend for every blend factor and blend operation.
+TEST(BlendModeSpanTest, MatchesBlendForAllFactorsAndOps)
+{
+    std::mt19937 rng( 42 );
+
+    for ( int srcFactor = 0; srcFactor <= static_cast<int>( BlendFactor::SrcAlphaSat ); ++srcFactor )
+    {
+        for ( int dstFactor = 0; dstFactor <= static_cast<int>( BlendFactor::SrcAlphaSat ); ++dstFactor )
+        {
+            for ( int op = 0; op <= static_cast<int>( BlendOperation::Max ); ++op )
+            {
+                const BlendMode blendMode {
+                    true, 0,
+                    static_cast<BlendFactor>( srcFactor ), static_cast<BlendFactor>( dstFactor ), static_cast<BlendOperation>( op ),
+                    static_cast<BlendFactor>( dstFactor ), static_cast<BlendFactor>( srcFactor ), static_cast<BlendOperation>( op )
+                };
+
+                const auto src = randomColors( rng, SpanSize );
+                const auto dst = randomColors( rng, SpanSize );
+
+                auto result = dst;
+                blendMode.blendSpan( src.data(), result.data(), SpanSize );
+
+                for ( size_t i = 0; i < SpanSize; ++i )
+                    ASSERT_EQ( result[i].rgba, blendMode.Blend( src[i], dst[i] ).rgba ) << "srcFactor=" << srcFactor << " dstFactor=" << dstFactor << " op=" << op << " i=" << i;
+            }
+        }
+    }
+}
+
+// Source pixels below the alpha threshold are discarded.
+TEST(BlendModeSpanTest, AlphaThreshold)
+{
+    std::mt19937 rng( 7 );
+
+    const auto src = randomColors( rng, SpanSize );
+    const auto dst = randomColors( rng, SpanSize );
+
+    for ( const BlendMode& blendMode: { BlendMode::AlphaDiscard, BlendMode { true, 200, BlendFactor::SrcAlpha, BlendFactor::OneMinusSrcAlpha } } )
+    {
+        auto result = dst;
+        blendMode.blendSpan( src.data(), result.data(), SpanSize );
+
+        for ( size_t i = 0; i < SpanSize; ++i )
+        {
+            if ( src[i].channels.a < blendMode.alphaThreshold )
+            {
+                EXPECT_EQ( result[i].rgba, dst[i].rgba );
+            }
+            EXPECT_EQ( result[i].rgba, blendMode.Blend( src[i], dst[i] ).rgba );
+        }
+    }
+}
+
+// The source colors are multiplied by the tint color before blending.
+TEST(BlendModeSpanTest, Tint)
+{
+    std::mt19937 rng( 1 );
+
+    const auto  src  = randomColors( rng, SpanSize );
+    const auto  dst  = randomColors( rng, SpanSize );
+    const Color tint { 255, 128, 64, 200 };
+
+    for ( const BlendMode& blendMode: { BlendMode::Disable, BlendMode::AlphaBlend, BlendMode::AdditiveBlend } )
+    {
+        auto result = dst;
+        blendMode.blendSpan( src.data(), result.data(), SpanSize, tint );
+
+        for ( size_t i = 0; i < SpanSize; ++i )
+            EXPECT_EQ( result[i].rgba, blendMode.Blend( src[i] * tint, dst[i] ).rgba );
+    }
+}
+
+// Blending a constant color produces the same result as blending a span of that color.
+TEST(BlendModeSpanTest, ConstantColor)
+{
+    std::mt19937 rng( 3 );
+
+    const auto  dst   = randomColors( rng, SpanSize );
+    const Color color { 32, 64, 128, 100 };
+
+    for ( const BlendMode& blendMode: { BlendMode::Disable, BlendMode::AlphaDiscard, BlendMode::AlphaBlend, BlendMode::AdditiveBlend, BlendMode::SubtractiveBlend, BlendMode::MultiplicativeBlend } )
+    {
+        auto result = dst;
+        blendMode.blendSpan( color, result.data(), SpanSize );
+
+        for ( size_t i = 0; i < SpanSize; ++i )
+            EXPECT_EQ( result[i].rgba, blendMode.Blend( color, dst[i] ).rgba );
+    }
+}
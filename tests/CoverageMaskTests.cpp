@@ -0,0 +1,155 @@
+#include <graphics/CoverageMask.hpp>
+#include <graphics/Rasterizer.hpp>
+#include <gtest/gtest.h>
+
+#include <random>
+#include <vector>
+
+using namespace sr;
+
+namespace
+{
+// A width that is not a multiple of 64, so the last word of each row is partially used.
+constexpr int Width  = 203;
+constexpr int Height = 4;
+
+// The runs of uncovered pixels [x, x + n) of a row of the reference mask in [x0, x1].
+std::vector<std::pair<int, int>> uncoveredRuns( const std::vector<bool>& row, int x0, int x1 )
+{
+    std::vector<std::pair<int, int>> runs;
+    for ( int x = x0; x <= x1; ++x )
+    {
+        if ( row[x] )
+            continue;
+
+        if ( !runs.empty() && runs.back().first + runs.back().second == x )
+            ++runs.back().second;
+        else
+            runs.emplace_back( x, 1 );
+    }
+
+    return runs;
+}
+}  // namespace
+
+// cover must set exactly the bits of the span, including spans that cross and end on word boundaries.
+TEST(CoverageMaskTest, Cover)
+{
+    std::mt19937                       rng( 16 );
+    std::uniform_int_distribution<int> dist( 0, Width - 1 );
+
+    CoverageMask                   mask( Width, Height );
+    std::vector<std::vector<bool>> expected( Height, std::vector<bool>( Width, false ) );
+
+    // Spans that start or end on a word boundary.
+    const std::pair<int, int> spans[] = { { 0, 0 }, { 63, 64 }, { 64, 127 }, { 130, 191 }, { 192, Width - 1 } };
+    for ( int y = 0; y < Height; ++y )
+    {
+        const auto [x0, x1] = spans[y];
+        mask.cover( y, x0, x1 );
+        for ( int x = x0; x <= x1; ++x )
+            expected[y][x] = true;
+    }
+
+    // Random spans.
+    for ( int i = 0; i < 20; ++i )
+    {
+        const int y  = i % Height;
+        int       x0 = dist( rng );
+        int       x1 = dist( rng );
+        if ( x0 > x1 )
+            std::swap( x0, x1 );
+
+        mask.cover( y, x0, x1 );
+        for ( int x = x0; x <= x1; ++x )
+            expected[y][x] = true;
+
+        for ( int yy = 0; yy < Height; ++yy )
+        {
+            for ( int x = 0; x < Width; ++x )
+                ASSERT_EQ( mask.isCovered( x, yy ), expected[yy][x] ) << "x=" << x << " y=" << yy;
+        }
+    }
+
+    mask.clear();
+    for ( int y = 0; y < Height; ++y )
+    {
+        for ( int x = 0; x < Width; ++x )
+            ASSERT_FALSE( mask.isCovered( x, y ) );
+    }
+}
+
+// forEachUncovered must report the runs of uncovered pixels (found 64 pixels at a time) in order.
+TEST(CoverageMaskTest, ForEachUncovered)
+{
+    std::mt19937                       rng( 61 );
+    std::uniform_int_distribution<int> dist( 0, Width - 1 );
+
+    for ( int i = 0; i < 200; ++i )
+    {
+        CoverageMask      mask( Width, 1 );
+        std::vector<bool> expected( Width, false );
+
+        // Cover a few random spans (some of them empty of uncovered pixels in whole words).
+        for ( int j = 0; j < i % 8; ++j )
+        {
+            int x0 = dist( rng );
+            int x1 = dist( rng );
+            if ( x0 > x1 )
+                std::swap( x0, x1 );
+
+            mask.cover( 0, x0, x1 );
+            for ( int x = x0; x <= x1; ++x )
+                expected[x] = true;
+        }
+
+        int x0 = dist( rng );
+        int x1 = dist( rng );
+        if ( x0 > x1 )
+            std::swap( x0, x1 );
+
+        std::vector<std::pair<int, int>> runs;
+        mask.forEachUncovered( 0, x0, x1, [&runs]( int x, int n ) { runs.emplace_back( x, n ); } );
+
+        EXPECT_EQ( runs, uncoveredRuns( expected, x0, x1 ) ) << "x0=" << x0 << " x1=" << x1;
+    }
+}
+
+// Opaque images cover the pixels they write and are rejected where the pixels are covered,
+// while translucent images are neither rejected nor cover any pixels.
+TEST(CoverageMaskTest, OnlyOpaqueImagesAreRejected)
+{
+    const Color front { 255, 0, 0, 255 };
+    const Color back { 0, 255, 0, 255 };
+    const Color glass { 0, 0, 255, 128 };
+
+    Image        target( Width, Height, Color::Black );
+    CoverageMask mask( Width, Height );
+
+    Rasterizer rasterizer;
+    rasterizer.state.colorTarget  = &target;
+    rasterizer.state.coverageMask = &mask;
+
+    // The front layer covers the left half of the target.
+    rasterizer.state.blendMode = BlendMode::Disable;
+    rasterizer.drawImage( Image( Width / 2, Height, front ), 0, 0 );
+
+    // The back layer is only drawn where the pixels are not covered.
+    rasterizer.drawImage( Image( Width, Height, back ), 0, 0 );
+
+    // A translucent layer is blended over the whole target.
+    rasterizer.state.blendMode = BlendMode::AlphaBlend;
+    rasterizer.drawImage( Image( Width, Height, glass ), 0, 0 );
+
+    target.resolveClear();
+
+    for ( int y = 0; y < Height; ++y )
+    {
+        for ( int x = 0; x < Width; ++x )
+        {
+            const Color expected = BlendMode::AlphaBlend.Blend( glass, x < Width / 2 ? front : back );
+            ASSERT_EQ( target( x, y ).rgba, expected.rgba ) << "x=" << x << " y=" << y;
+            ASSERT_TRUE( mask.isCovered( x, y ) );
+        }
+    }
+}
@@ -0,0 +1,447 @@
+#include <graphics/Rasterizer.hpp>
+#include <gtest/gtest.h>
+
+#include <filesystem>
+#include <initializer_list>
+#include <random>
+#include <vector>
+
+using namespace sr;
+
+namespace
+{
+// Not a multiple of the clear and dirty tile sizes, so the last column and row of tiles are partial.
+constexpr uint32_t Width  = 200;
+constexpr uint32_t Height = 150;
+
+const Color ClearColor { 40, 80, 120, 255 };
+
+// Compare the pixels of two images (after resolving their lazy clears).
+void expectEqual( const Image& a, const Image& b )
+{
+    a.resolveClear();
+    b.resolveClear();
+
+    ASSERT_EQ( a.getWidth(), b.getWidth() );
+    ASSERT_EQ( a.getHeight(), b.getHeight() );
+
+    for ( int i = 0; i < a.getWidth() * a.getHeight(); ++i )
+        ASSERT_EQ( a.data()[i].rgba, b.data()[i].rgba ) << "x=" << i % a.getWidth() << " y=" << i / a.getWidth();
+}
+
+// An image with garbage pixels, so pixels that a lazy clear doesn't resolve are detected.
+Image garbageImage()
+{
+    Image image( Width, Height );
+
+    std::mt19937 rng( 0 );
+    for ( uint32_t i = 0; i < Width * Height; ++i )
+        image.data()[i] = Color { static_cast<uint32_t>( rng() ) };
+
+    return image;
+}
+
+// Draw a mix of primitives that only cover parts of the tiles of the image (including batched draw calls).
+void drawScene( Rasterizer& rasterizer, const Image& sprite )
+{
+    std::mt19937                       rng( 17 );
+    std::uniform_int_distribution<int> x( -20, Width + 20 );
+    std::uniform_int_distribution<int> y( -20, Height + 20 );
+
+    std::vector<glm::vec2> points;
+    std::vector<Circle>    circles;
+
+    for ( int i = 0; i < 20; ++i )
+    {
+        rasterizer.state.color     = Color { static_cast<uint8_t>( i * 12 ), 200, 100, 128 };
+        rasterizer.state.blendMode = i % 2 ? BlendMode::AlphaBlend : BlendMode::Disable;
+
+        const int x0 = x( rng ), y0 = y( rng );
+        rasterizer.drawAABB( AABB::fromMinMax( { x0, y0, 0 }, { x0 + static_cast<int>( rng() % 30 ), y0 + static_cast<int>( rng() % 30 ), 0 } ) );
+        rasterizer.drawLine( x( rng ), y( rng ), x( rng ), y( rng ) );
+        rasterizer.drawTriangle( { x( rng ), y( rng ) }, { x( rng ), y( rng ) }, { x( rng ), y( rng ) } );
+        rasterizer.drawImage( sprite, x( rng ), y( rng ) );
+
+        points.emplace_back( x( rng ), y( rng ) );
+        circles.emplace_back( glm::vec2 { x( rng ), y( rng ) }, static_cast<float>( rng() % 10 ) );
+    }
+
+    rasterizer.drawPoints( points );
+    rasterizer.drawCircles( circles );
+}
+
+// The dirty tiles of an image (a flag per tile of DirtyTileSize x DirtyTileSize pixels), taken from its dirty rectangles.
+// The rectangles must be aligned to the tiles (or to the edges of the image) and must not overlap.
+std::vector<bool> takeDirtyTiles( const Image& image )
+{
+    constexpr int T       = Image::DirtyTileSize;
+    const int     columns = ( image.getWidth() + T - 1 ) / T;
+    const int     rows    = ( image.getHeight() + T - 1 ) / T;
+
+    std::vector<bool> tiles( static_cast<size_t>( columns * rows ) );
+    for ( const math::RectI& rect: image.takeDirtyRects() )
+    {
+        EXPECT_EQ( rect.left % T, 0 );
+        EXPECT_EQ( rect.top % T, 0 );
+        EXPECT_TRUE( rect.right() % T == 0 || rect.right() == image.getWidth() );
+        EXPECT_TRUE( rect.bottom() % T == 0 || rect.bottom() == image.getHeight() );
+
+        for ( int y = rect.top / T; y < ( rect.bottom() + T - 1 ) / T; ++y )
+        {
+            for ( int x = rect.left / T; x < ( rect.right() + T - 1 ) / T; ++x )
+            {
+                EXPECT_FALSE( tiles[y * columns + x] ) << "The tile (" << x << ", " << y << ") is in more than one rectangle.";
+                tiles[y * columns + x] = true;
+            }
+        }
+    }
+
+    return tiles;
+}
+
+// The tiles that overlap any of the regions of the image.
+std::vector<bool> tilesOf( const Image& image, std::initializer_list<AABB> regions )
+{
+    constexpr int T       = Image::DirtyTileSize;
+    const int     columns = ( image.getWidth() + T - 1 ) / T;
+    const int     rows    = ( image.getHeight() + T - 1 ) / T;
+
+    std::vector<bool> tiles( static_cast<size_t>( columns * rows ) );
+    for ( int y = 0; y < rows; ++y )
+    {
+        for ( int x = 0; x < columns; ++x )
+        {
+            for ( const AABB& region: regions )
+            {
+                const AABB aabb = region.clamped( image.getAABB() );
+                tiles[y * columns + x] = tiles[y * columns + x] || ( aabb.max.x >= x * T && aabb.min.x < ( x + 1 ) * T && aabb.max.y >= y * T && aabb.min.y < ( y + 1 ) * T && aabb.min.x <= aabb.max.x && aabb.min.y <= aabb.max.y );
+            }
+        }
+    }
+
+    return tiles;
+}
+}  // namespace
+
+// fastClear followed by draws that only cover parts of some tiles must give the same pixels as clearing the image first.
+// The pixels of a tile that aren't drawn to are cleared when the tile is resolved.
+TEST(ImageFastClearTest, PartiallyCoveredTiles)
+{
+    const Image sprite( 12, 9, Color { 255, 255, 0, 200 } );
+
+    Image expected( Width, Height, ClearColor );
+    Image actual = garbageImage();
+
+    Rasterizer rasterizer;
+    rasterizer.state.colorTarget = &expected;
+    drawScene( rasterizer, sprite );
+
+    actual.fastClear( ClearColor );
+    rasterizer.state.colorTarget = &actual;
+    drawScene( rasterizer, sprite );
+
+    expectEqual( expected, actual );
+}
+
+// Binned draw calls resolve the tiles of a lazy clear when the binner is flushed, from the threads that rasterize the tiles.
+// The pixels must be the same as drawing immediately to an image that was cleared first.
+TEST(ImageFastClearTest, BinnedMatchesImmediate)
+{
+    const Image sprite( 12, 9, Color { 255, 255, 0, 200 } );
+
+    Image expected( Width, Height, ClearColor );
+
+    Rasterizer rasterizer;
+    rasterizer.state.colorTarget = &expected;
+    drawScene( rasterizer, sprite );
+
+    for ( int tileSize: { 16, 50, 64, 256 } )
+    {
+        Image actual = garbageImage();
+        actual.fastClear( ClearColor );
+
+        rasterizer.state.colorTarget = &actual;
+        rasterizer.beginBinning( tileSize );
+        drawScene( rasterizer, sprite );
+        rasterizer.endBinning();
+
+        SCOPED_TRACE( tileSize );
+        expectEqual( expected, actual );
+    }
+}
+
+// Batched primitives (points, lines, and circles) only resolve the part of a tile that their bounds cover.
+// Without any other draw calls, every pixel that they write must be in a resolved tile.
+TEST(ImageFastClearTest, BatchedPrimitives)
+{
+    std::mt19937                          rng( 18 );
+    std::uniform_real_distribution<float> x( -20.0f, Width + 20.0f );
+    std::uniform_real_distribution<float> y( -20.0f, Height + 20.0f );
+
+    std::vector<glm::vec2> points;
+    std::vector<Circle>    circles;
+    for ( int i = 0; i < 40; ++i )
+    {
+        points.emplace_back( x( rng ), y( rng ) );
+        circles.emplace_back( glm::vec2 { x( rng ), y( rng ) }, static_cast<float>( rng() % 20 ) );
+    }
+
+    auto draw = [&]( Rasterizer& rasterizer ) {
+        rasterizer.drawPoints( points );
+        rasterizer.drawLines( points );
+        rasterizer.drawCircles( circles );
+    };
+
+    Image expected( Width, Height, ClearColor );
+
+    Rasterizer rasterizer;
+    rasterizer.state.color       = Color { 255, 0, 255, 160 };
+    rasterizer.state.blendMode   = BlendMode::AlphaBlend;
+    rasterizer.state.colorTarget = &expected;
+    draw( rasterizer );
+
+    for ( int tileSize: { 0, 16, 64 } )
+    {
+        Image actual = garbageImage();
+        actual.fastClear( ClearColor );
+
+        rasterizer.state.colorTarget = &actual;
+        if ( tileSize > 0 )
+            rasterizer.beginBinning( tileSize );
+        draw( rasterizer );
+        if ( tileSize > 0 )
+            rasterizer.endBinning();
+
+        SCOPED_TRACE( tileSize );
+        expectEqual( expected, actual );
+    }
+}
+
+// The tiles that are completely inside of the overwritten region are resolved without clearing them,
+// and the tiles that are only partly inside of it are cleared.
+TEST(ImageFastClearTest, OverwrittenTilesAreNotCleared)
+{
+    constexpr int T = Image::ClearTileSize;
+
+    Image image = garbageImage();
+    Image garbage( image );
+    image.fastClear( ClearColor );
+
+    // Tile (0, 0) is overwritten, tile (1, 0) is only partly overwritten.
+    const AABB accessed    = AABB::fromMinMax( { 0, 0, 0 }, { 2 * T - 1, T - 1, 0 } );
+    const AABB overwritten = AABB::fromMinMax( { 0, 0, 0 }, { T + 10, T - 1, 0 } );
+    image.resolveClear( accessed, overwritten );
+
+    EXPECT_EQ( image( 0, 0 ), garbage( 0, 0 ) );
+    EXPECT_EQ( image( T - 1, T - 1 ), garbage( T - 1, T - 1 ) );
+    EXPECT_EQ( image( T, 0 ), ClearColor );
+    EXPECT_EQ( image( 2 * T - 1, T - 1 ), ClearColor );
+
+    // The overwritten tile was resolved, so it isn't cleared later. The remaining tiles are cleared.
+    image.resolveClear();
+
+    for ( int y = 0; y < image.getHeight(); ++y )
+    {
+        for ( int x = 0; x < image.getWidth(); ++x )
+        {
+            const Color expected = x < T && y < T ? garbage( x, y ) : ClearColor;
+            ASSERT_EQ( image( x, y ), expected ) << "x=" << x << " y=" << y;
+        }
+    }
+}
+
+// An opaque blit that covers whole tiles skips clearing them, but must still give the same pixels as clearing first.
+TEST(ImageFastClearTest, OpaqueDrawImage)
+{
+    // The first blit covers the tiles (1, 0) and (1, 1) of the lazy clear.
+    Image sprite( 150, 140 );
+    for ( int y = 0; y < sprite.getHeight(); ++y )
+    {
+        for ( int x = 0; x < sprite.getWidth(); ++x )
+            sprite( x, y ) = Color { static_cast<uint8_t>( x ), static_cast<uint8_t>( y ), 7, 255 };
+    }
+
+    for ( const BlendMode& blendMode: { BlendMode::Disable, BlendMode::AlphaBlend } )
+    {
+        Image expected( Width, Height, ClearColor );
+        Image actual = garbageImage();
+        actual.fastClear( ClearColor );
+
+        Rasterizer rasterizer;
+        rasterizer.state.blendMode = blendMode;
+
+        for ( Image* image: { &expected, &actual } )
+        {
+            rasterizer.state.colorTarget = image;
+            rasterizer.drawImage( sprite, 3, -5 );
+            rasterizer.drawImage( sprite, 120, 90 );
+        }
+
+        expectEqual( expected, actual );
+    }
+}
+
+// Copying and saving an image resolve the tiles of a lazy clear that were never drawn to.
+TEST(ImageFastClearTest, CopyAndSaveResolve)
+{
+    Image expected( Width, Height, ClearColor );
+    Image image = garbageImage();
+    image.fastClear( ClearColor );
+
+    // Draw to a single tile, the rest of the tiles are still pending.
+    Rasterizer rasterizer;
+    rasterizer.state.color = Color::Red;
+    for ( Image* target: { &expected, &image } )
+    {
+        rasterizer.state.colorTarget = target;
+        rasterizer.drawAABB( AABB::fromMinMax( { 70, 70, 0 }, { 80, 80, 0 } ) );
+    }
+
+    const Image copy( image );
+    expectEqual( expected, copy );
+
+    Image assigned;
+    image.fastClear( ClearColor );
+    rasterizer.drawAABB( AABB::fromMinMax( { 70, 70, 0 }, { 80, 80, 0 } ) );
+    assigned = image;
+    expectEqual( expected, assigned );
+
+    image.fastClear( ClearColor );
+    rasterizer.drawAABB( AABB::fromMinMax( { 70, 70, 0 }, { 80, 80, 0 } ) );
+
+    const std::filesystem::path file = std::filesystem::temp_directory_path() / "ImageFastClearTest.png";
+    image.save( file );
+
+    const Image loaded( file );
+    std::filesystem::remove( file );
+
+    expectEqual( expected, loaded );
+}
+
+// A new image is dirty: a single rectangle covers the whole image, including the partial last column and row of tiles.
+// Taking the dirty rectangles marks the image as clean.
+TEST(ImageDirtyRectsTest, TakeResetsTiles)
+{
+    const Image image( Width, Height );
+
+    const std::vector<math::RectI> rects = image.takeDirtyRects();
+    ASSERT_EQ( rects.size(), 1u );
+    EXPECT_EQ( rects[0], math::RectI( 0, 0, Width, Height ) );
+
+    EXPECT_TRUE( image.takeDirtyRects().empty() );
+}
+
+// Runs of dirty tiles in a row are merged, and the rectangles of rows with the same run are merged.
+TEST(ImageDirtyRectsTest, MergeRuns)
+{
+    constexpr int T = Image::DirtyTileSize;
+
+    Image image( Width, Height );
+    image.takeDirtyRects();
+
+    // Tiles 1...3 of the rows 0 and 1 (a single rectangle), tiles 1...2 of row 2 (a different run), and tile 5 of row 1.
+    image.markDirty( AABB::fromMinMax( { T, 0, 0 }, { 4 * T - 1, 2 * T - 1, 0 } ) );
+    image.markDirty( AABB::fromMinMax( { T + 5, 2 * T + 5, 0 }, { 3 * T - 5, 3 * T - 5, 0 } ) );
+    image.markDirty( 5 * T + 3, T + 3 );
+
+    const std::vector<math::RectI> rects = image.takeDirtyRects();
+    ASSERT_EQ( rects.size(), 3u );
+    EXPECT_EQ( rects[0], math::RectI( T, 0, 3 * T, 2 * T ) );
+    EXPECT_EQ( rects[1], math::RectI( 5 * T, T, T, T ) );
+    EXPECT_EQ( rects[2], math::RectI( T, 2 * T, 2 * T, T ) );
+
+    // The partial tile in the bottom-right corner.
+    image.markDirty( AABB::fromMinMax( { Width - 1, Height - 1, 0 }, { Width + 10, Height + 10, 0 } ) );
+    EXPECT_EQ( image.takeDirtyRects(), std::vector { math::RectI( 6 * T, 4 * T, Width - 6 * T, Height - 4 * T ) } );
+
+    // The entire last column (partial tiles) is merged over all of the rows.
+    image.markDirty( AABB::fromMinMax( { Width - 2, 0, 0 }, { Width - 1, Height - 1, 0 } ) );
+    EXPECT_EQ( image.takeDirtyRects(), std::vector { math::RectI( 6 * T, 0, Width - 6 * T, Height ) } );
+
+    EXPECT_TRUE( image.takeDirtyRects().empty() );
+}
+
+// Random dirty regions: the rectangles must cover exactly the tiles that were marked.
+TEST(ImageDirtyRectsTest, RandomRegions)
+{
+    std::mt19937                       rng( 18 );
+    std::uniform_int_distribution<int> x( -10, Width + 10 );
+    std::uniform_int_distribution<int> y( -10, Height + 10 );
+
+    Image image( Width, Height );
+    image.takeDirtyRects();
+
+    for ( int i = 0; i < 100; ++i )
+    {
+        std::vector<bool> expected = tilesOf( image, {} );
+        for ( int j = 0; j < 3; ++j )
+        {
+            const AABB aabb = AABB::fromMinMax( { x( rng ), y( rng ), 0 }, { x( rng ), y( rng ), 0 } );
+            if ( aabb.min.x > aabb.max.x || aabb.min.y > aabb.max.y )
+                continue;
+
+            image.markDirty( aabb );
+
+            const std::vector<bool> tiles = tilesOf( image, { aabb } );
+            for ( size_t t = 0; t < tiles.size(); ++t )
+                expected[t] = expected[t] || tiles[t];
+        }
+
+        ASSERT_EQ( takeDirtyTiles( image ), expected ) << "i=" << i;
+    }
+}
+
+// Draw calls only mark the tiles that they write to (drawImage and drawAABB, and batches of points and circles).
+TEST(ImageDirtyRectsTest, DrawCallsMarkTheirTiles)
+{
+    constexpr int T = Image::DirtyTileSize;
+
+    const Image sprite( 10, 10, Color::Red );
+
+    for ( int tileSize: { 0, 16, 64 } )
+    {
+        SCOPED_TRACE( tileSize );
+
+        Image      image( Width, Height, Color::Black );
+        Rasterizer rasterizer;
+        rasterizer.state.colorTarget = &image;
+
+        auto flush = [&]( auto&& draw ) {
+            image.takeDirtyRects();
+
+            if ( tileSize > 0 )
+                rasterizer.beginBinning( tileSize );
+            draw();
+            if ( tileSize > 0 )
+                rasterizer.endBinning();
+
+            return takeDirtyTiles( image );
+        };
+
+        // Across the corner of 4 tiles.
+        EXPECT_EQ( flush( [&] { rasterizer.drawImage( sprite, T - 5, T - 5 ); } ), tilesOf( image, { AABB::fromMinMax( { T - 5, T - 5, 0 }, { T + 4, T + 4, 0 } ) } ) );
+
+        // Partly outside of the image.
+        EXPECT_EQ( flush( [&] { rasterizer.drawImage( sprite, Width - 5, -5 ); } ), tilesOf( image, { AABB::fromMinMax( { Width - 5, 0, 0 }, { Width - 1, 4, 0 } ) } ) );
+
+        // Inside of a single tile.
+        const AABB aabb = AABB::fromMinMax( { 2 * T + 1, 3 * T + 1, 0 }, { 3 * T - 2, 4 * T - 2, 0 } );
+        EXPECT_EQ( flush( [&] { rasterizer.drawAABB( aabb ); } ), tilesOf( image, { aabb } ) );
+
+        // A few points and a small circle: only their tiles are dirty, not the tiles of the batches.
+        // The primitives are in different tiles of the batches (rows of 64 pixels in immediate mode), since the region
+        // of a tile of a batch is the union of the bounds of its primitives.
+        const glm::vec2         points[]  = { { 3, 3 }, { 3 * T + 3, 2 * T + 3 } };
+        const Circle            circles[] = { Circle { { 4 * T + 10, 4 * T + 10 }, 5 } };
+        const std::vector<bool> expected  = tilesOf( image, { AABB::fromMinMax( { 3, 3, 0 }, { 3, 3, 0 } ), AABB::fromMinMax( { 3 * T + 3, 2 * T + 3, 0 }, { 3 * T + 3, 2 * T + 3, 0 } ), AABB::fromMinMax( { 4 * T + 5, 4 * T + 5, 0 }, { 4 * T + 15, 4 * T + 15, 0 } ) } );
+
+        EXPECT_EQ( flush( [&] {
+                       rasterizer.drawPoints( points );
+                       rasterizer.drawCircles( circles );
+                   } ),
+                   expected );
+
+        // Nothing is drawn.
+        EXPECT_EQ( flush( [&] { rasterizer.drawAABB( AABB::fromMinMax( { -20, -20, 0 }, { -10, -10, 0 } ) ); } ), tilesOf( image, {} ) );
+    }
+}
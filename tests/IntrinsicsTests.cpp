@@ -0,0 +1,78 @@
+#include <math/Intrinsics.hpp>
+#include <gtest/gtest.h>
+
+#include <random>
+
+using namespace sr::math;
+
+namespace
+{
+// The coverage mask computed one pixel at a time (the same as the scalar fallback of simd_edge_coverage_mask8).
+int coverageMask( const int* w, const int* dY )
+{
+    int mask = 0;
+    for ( int i = 0; i < 8; ++i )
+    {
+        bool inside = true;
+        for ( int e = 0; e < 3; ++e )
+            inside = inside && w[e] + i * dY[e] >= 0;
+
+        mask |= inside << i;
+    }
+
+    return mask;
+}
+}  // namespace
+
+// The SIMD coverage mask (SSE2, AVX2, or NEON, depending on the build) must match testing each pixel.
+// The weights are close to 0, so that pixels on both sides of the edges (and exactly on them) are tested.
+// A weight of -1 is a pixel on an edge that isn't a top or left edge (see the fill rule bias of the rasterizer).
+TEST(EdgeCoverageMaskTest, MatchesPerPixelTest)
+{
+    std::mt19937                       rng( 4 );
+    std::uniform_int_distribution<int> weight( -64, 64 );
+    std::uniform_int_distribution<int> step( -16, 16 );
+    std::uniform_int_distribution<int> special( 0, 3 );
+
+    for ( int i = 0; i < 100000; ++i )
+    {
+        int w[3], dY[3];
+        for ( int e = 0; e < 3; ++e )
+        {
+            dY[e] = step( rng );
+
+            // Weights that are 0 or -1 at one of the 8 pixels.
+            switch ( special( rng ) )
+            {
+            case 0:
+                w[e] = -dY[e] * static_cast<int>( rng() % 8 );
+                break;
+            case 1:
+                w[e] = -1 - dY[e] * static_cast<int>( rng() % 8 );
+                break;
+            default:
+                w[e] = weight( rng );
+                break;
+            }
+        }
+
+        ASSERT_EQ( simd_edge_coverage_mask8( w, dY ), coverageMask( w, dY ) )
+            << "w=(" << w[0] << ", " << w[1] << ", " << w[2] << ") dY=(" << dY[0] << ", " << dY[1] << ", " << dY[2] << ")";
+    }
+}
+
+// Large weights (for example, the edges of a large triangle far from the pixels) must not change the sign of the mask.
+TEST(EdgeCoverageMaskTest, LargeWeights)
+{
+    constexpr int Large = 1 << 28;
+
+    const int inside[3]  = { Large, Large, Large };
+    const int outside[3] = { Large, -Large, Large };
+    const int zero[3]    = { 0, 0, 0 };
+    const int dY[3]      = { -Large / 8, 0, Large / 8 };
+
+    EXPECT_EQ( simd_edge_coverage_mask8( inside, zero ), 0xFF );
+    EXPECT_EQ( simd_edge_coverage_mask8( outside, zero ), 0 );
+    EXPECT_EQ( simd_edge_coverage_mask8( zero, zero ), 0xFF );
+    EXPECT_EQ( simd_edge_coverage_mask8( inside, dY ), coverageMask( inside, dY ) );
+}
@@ -0,0 +1,486 @@
+#include <graphics/Rasterizer.hpp>
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <numeric>
+#include <random>
+#include <span>
+#include <vector>
+
+using namespace sr;
+
+namespace
+{
+constexpr uint32_t Width  = 160;
+constexpr uint32_t Height = 120;
+
+// Random points, some of which are outside of the color target (so the lines are clipped).
+std::vector<glm::vec2> randomPoints( std::mt19937& rng, size_t n )
+{
+    std::uniform_real_distribution<float> x( -80.0f, Width + 80.0f );
+    std::uniform_real_distribution<float> y( -60.0f, Height + 60.0f );
+
+    std::vector<glm::vec2> points( n );
+    for ( auto& p: points )
+        p = { x( rng ), y( rng ) };
+
+    return points;
+}
+
+// Compare the pixels of two images.
+void expectEqual( Image& a, Image& b )
+{
+    a.resolveClear();
+    b.resolveClear();
+
+    ASSERT_EQ( a.getWidth(), b.getWidth() );
+    ASSERT_EQ( a.getHeight(), b.getHeight() );
+
+    for ( int i = 0; i < a.getWidth() * a.getHeight(); ++i )
+        ASSERT_EQ( a.data()[i].rgba, b.data()[i].rgba ) << "x=" << i % a.getWidth() << " y=" << i / a.getWidth();
+}
+
+// The per-pixel inside test of the edge functions of the rasterizer: each edge function is evaluated at the
+// center of the pixel (the half-pixel offset is rounded towards zero), and pixels that are exactly on an edge
+// are only inside if it is a top or left edge.
+bool inside( glm::ivec2 p0, glm::ivec2 p1, glm::ivec2 p2, const glm::ivec2& p )
+{
+    if ( orient2D( p0, p1, p2 ) < 0 )
+        std::swap( p1, p2 );
+
+    const glm::ivec2 edges[][2] = { { p1, p2 }, { p2, p0 }, { p0, p1 } };
+    for ( const auto& [a, b]: edges )
+    {
+        const int halfPixel = ( b.x - a.x + a.y - b.y ) / 2;
+        const int bias      = isTopLeft( a, b ) ? 0 : -1;
+
+        if ( orient2D( a, b, p ) + halfPixel + bias < 0 )
+            return false;
+    }
+
+    return true;
+}
+
+// Draw triangles by testing every pixel of their bounding box (clipped to the image), adding color for each
+// triangle that covers a pixel. This is the reference for the block and span traversals of the rasterizer.
+void drawReference( Image& image, std::span<const glm::ivec2> positions, std::span<const uint32_t> triangles, const Color& color )
+{
+    for ( size_t i = 0; i + 2 < triangles.size(); i += 3 )
+    {
+        const glm::ivec2& p0 = positions[triangles[i + 0]];
+        const glm::ivec2& p1 = positions[triangles[i + 1]];
+        const glm::ivec2& p2 = positions[triangles[i + 2]];
+
+        if ( orient2D( p0, p1, p2 ) == 0 )
+            continue;
+
+        const glm::ivec2 min = glm::max( glm::min( glm::min( p0, p1 ), p2 ), glm::ivec2 { 0 } );
+        const glm::ivec2 max = glm::min( glm::max( glm::max( p0, p1 ), p2 ), glm::ivec2 { Width - 1, Height - 1 } );
+
+        for ( int y = min.y; y <= max.y; ++y )
+        {
+            for ( int x = min.x; x <= max.x; ++x )
+            {
+                if ( inside( p0, p1, p2, { x, y } ) )
+                    image( x, y ) = BlendMode::AdditiveBlend.Blend( color, image( x, y ) );
+            }
+        }
+    }
+}
+
+// Draw a textured quad with a texture of a single color, and the same quad with the reference.
+void drawQuad( Rasterizer& rasterizer, Image& reference, const glm::ivec2 ( &quad )[4], const Image& texture )
+{
+    rasterizer.drawQuad( Vertex2D { glm::vec2 { quad[0] } }, Vertex2D { glm::vec2 { quad[1] } }, Vertex2D { glm::vec2 { quad[2] } }, Vertex2D { glm::vec2 { quad[3] } }, texture );
+
+    const uint32_t triangles[] = { 0, 1, 2, 2, 3, 0 };
+    drawReference( reference, quad, triangles, texture( 0, 0 ) );
+}
+
+// Draw a textured triangle with a texture of a single color, and the same triangle with the reference.
+void drawTriangle( Rasterizer& rasterizer, Image& reference, const glm::ivec2 ( &triangle )[3], const Image& texture )
+{
+    rasterizer.drawTriangle( Vertex2D { glm::vec2 { triangle[0] } }, Vertex2D { glm::vec2 { triangle[1] } }, Vertex2D { glm::vec2 { triangle[2] } }, texture );
+
+    const uint32_t triangles[] = { 0, 1, 2 };
+    drawReference( reference, triangle, triangles, texture( 0, 0 ) );
+}
+}  // namespace
+
+// drawLines must produce the same pixels as calling drawLine for each line.
+TEST(RasterizerLinesTest, DrawLinesMatchesDrawLine)
+{
+    std::mt19937 rng( 15 );
+
+    for ( const BlendMode& blendMode: { BlendMode::Disable, BlendMode::AlphaBlend, BlendMode::AdditiveBlend } )
+    {
+        for ( const Viewport& viewport: { Viewport {}, Viewport { 20.0f, 10.0f, 100.0f, 70.0f } } )
+        {
+            const auto points = randomPoints( rng, 2000 );
+
+            Image expected( Width, Height, Color::Black );
+            Image actual( Width, Height, Color::Black );
+
+            Rasterizer rasterizer;
+            rasterizer.state.color     = Color { 255, 128, 64, 100 };
+            rasterizer.state.blendMode = blendMode;
+            rasterizer.state.viewport  = viewport;
+
+            rasterizer.state.colorTarget = &expected;
+            for ( size_t i = 0; i + 1 < points.size(); i += 2 )
+                rasterizer.drawLine( points[i], points[i + 1] );
+
+            rasterizer.state.colorTarget = &actual;
+            rasterizer.drawLines( points );
+
+            expectEqual( expected, actual );
+        }
+    }
+}
+
+// drawPolyline must produce the same pixels as calling drawLine for each pair of consecutive points.
+TEST(RasterizerLinesTest, DrawPolylineMatchesDrawLine)
+{
+    std::mt19937 rng( 16 );
+
+    for ( bool closed: { false, true } )
+    {
+        const auto points = randomPoints( rng, 500 );
+
+        Image expected( Width, Height, Color::Black );
+        Image actual( Width, Height, Color::Black );
+
+        Rasterizer rasterizer;
+        rasterizer.state.color     = Color { 64, 255, 128, 100 };
+        rasterizer.state.blendMode = BlendMode::AlphaBlend;
+
+        rasterizer.state.colorTarget = &expected;
+        for ( size_t i = 0; i + 1 < points.size(); ++i )
+            rasterizer.drawLine( points[i], points[i + 1] );
+        if ( closed )
+            rasterizer.drawLine( points.back(), points.front() );
+
+        rasterizer.state.colorTarget = &actual;
+        rasterizer.drawPolyline( points, closed );
+
+        expectEqual( expected, actual );
+    }
+}
+
+// Binned lines must produce the same pixels as lines that are drawn immediately.
+TEST(RasterizerLinesTest, BinnedDrawLinesMatchesDrawLine)
+{
+    std::mt19937 rng( 17 );
+
+    const auto points = randomPoints( rng, 2000 );
+
+    Image expected( Width, Height, Color::Black );
+    Image actual( Width, Height, Color::Black );
+
+    Rasterizer rasterizer;
+    rasterizer.state.color     = Color { 128, 64, 255, 100 };
+    rasterizer.state.blendMode = BlendMode::AlphaBlend;
+
+    rasterizer.state.colorTarget = &expected;
+    for ( size_t i = 0; i + 1 < points.size(); i += 2 )
+        rasterizer.drawLine( points[i], points[i + 1] );
+
+    rasterizer.state.colorTarget = &actual;
+    rasterizer.beginBinning( 32 );
+    rasterizer.drawLines( points );
+    rasterizer.endBinning();
+
+    expectEqual( expected, actual );
+}
+
+// Each tile of the binner starts stepping a line where it enters the tile. The pixels must be the same as stepping
+// the entire line with Bresenham's algorithm (with lines in all directions, so the lines cross many tiles).
+TEST(RasterizerLinesTest, BinnedLinesMatchBresenham)
+{
+    std::mt19937                       rng( 1 );
+    std::uniform_int_distribution<int> x( 0, Width - 1 );
+    std::uniform_int_distribution<int> y( 0, Height - 1 );
+
+    std::vector<glm::vec2> points( 400 );
+    for ( auto& p: points )
+        p = { x( rng ), y( rng ) };
+
+    // Horizontal, vertical, and diagonal lines.
+    points.insert( points.end(), { { 0, 5 }, { Width - 1, 5 }, { 7, Height - 1 }, { 7, 0 }, { 0, 0 }, { Height - 1, Height - 1 }, { Width - 1, 0 }, { Width - Height, Height - 1 } } );
+
+    const Color color { 200, 100, 50, 255 };
+
+    Image expected( Width, Height, Color::Black );
+    for ( size_t i = 0; i + 1 < points.size(); i += 2 )
+    {
+        int x0 = static_cast<int>( points[i].x ), y0 = static_cast<int>( points[i].y );
+        int x1 = static_cast<int>( points[i + 1].x ), y1 = static_cast<int>( points[i + 1].y );
+
+        const bool low = std::abs( y1 - y0 ) < std::abs( x1 - x0 );
+        if ( low ? x0 > x1 : y0 > y1 )
+        {
+            std::swap( x0, x1 );
+            std::swap( y0, y1 );
+        }
+
+        const int major     = low ? x1 - x0 : y1 - y0;
+        const int minor     = std::abs( low ? y1 - y0 : x1 - x0 );
+        const int minorSign = ( low ? y1 - y0 : x1 - x0 ) < 0 ? -1 : 1;
+
+        glm::ivec2 p { x0, y0 };
+        int        D = 2 * minor - major;
+        for ( int step = 0; step <= major; ++step )
+        {
+            expected( p.x, p.y ) = color;
+
+            ( low ? p.x : p.y ) += 1;
+            if ( D > 0 )
+            {
+                ( low ? p.y : p.x ) += minorSign;
+                D -= 2 * major;
+            }
+            D += 2 * minor;
+        }
+    }
+
+    for ( int tileSize: { 8, 13, 64 } )
+    {
+        Image actual( Width, Height, Color::Black );
+
+        Rasterizer rasterizer;
+        rasterizer.state.colorTarget = &actual;
+        rasterizer.state.color       = color;
+
+        rasterizer.beginBinning( tileSize );
+        for ( size_t i = 0; i + 1 < points.size(); i += 2 )
+            rasterizer.drawLine( points[i], points[i + 1] );
+        rasterizer.drawLines( points );
+        rasterizer.endBinning();
+
+        SCOPED_TRACE( tileSize );
+        expectEqual( expected, actual );
+    }
+}
+
+// Changing the color target while binning flushes the draw calls of the previous target first,
+// so an image that was rendered to can be drawn to the next target.
+TEST(RasterizerBinningTest, ChangeColorTarget)
+{
+    std::mt19937 rng( 25 );
+
+    const auto points = randomPoints( rng, 200 );
+
+    auto render = [&points]( Rasterizer& rasterizer, Image& texture, Image& target ) {
+        for ( size_t i = 0; i + 1 < points.size(); i += 2 )
+        {
+            rasterizer.state.colorTarget = &texture;
+            rasterizer.state.blendMode   = BlendMode::Disable;
+            rasterizer.state.color       = Color { static_cast<uint8_t>( i ), 64, 255, 255 };
+            rasterizer.drawLine( points[i], points[i + 1] );
+
+            rasterizer.state.colorTarget = &target;
+            rasterizer.state.blendMode   = BlendMode::AlphaBlend;
+            rasterizer.drawImage( texture, static_cast<int>( i % 40 ) - 20, static_cast<int>( i % 30 ) - 15 );
+        }
+    };
+
+    Image expectedTexture( Width, Height, Color::Black );
+    Image expectedTarget( Width, Height, Color::Black );
+    Image actualTexture( Width, Height, Color::Black );
+    Image actualTarget( Width, Height, Color::Black );
+
+    Rasterizer rasterizer;
+    render( rasterizer, expectedTexture, expectedTarget );
+
+    rasterizer.beginBinning( 32 );
+    render( rasterizer, actualTexture, actualTarget );
+    rasterizer.endBinning();
+
+    expectEqual( expectedTexture, actualTexture );
+    expectEqual( expectedTarget, actualTarget );
+}
+
+// Quads that cover most of their bounding box are rasterized in 8x8 blocks, which are either skipped, filled, or tested
+// per pixel. The covered pixels must be the same as testing every pixel of the bounding box. The quads are (nearly)
+// axis-aligned so their blocks are full, partial, and outside, and include quads that are smaller than a single block.
+TEST(RasterizerTrianglesTest, BlocksMatchPerPixelTest)
+{
+    std::mt19937                       rng( 3 );
+    std::uniform_int_distribution<int> position( -20, Width + 20 );
+    std::uniform_int_distribution<int> size( 1, 60 );
+    std::uniform_int_distribution<int> jitter( -1, 1 );
+
+    // Additive blending, so pixels that are drawn twice (for example, on the diagonal of a quad) are detected.
+    const Image texture( 1, 1, Color { 30, 20, 10, 255 } );
+
+    Image expected( Width, Height, Color::Black );
+    Image actual( Width, Height, Color::Black );
+
+    Rasterizer rasterizer;
+    rasterizer.state.colorTarget = &actual;
+    rasterizer.state.blendMode   = BlendMode::AdditiveBlend;
+    rasterizer.state.cullMode    = CullMode::None;
+
+    for ( int i = 0; i < 300; ++i )
+    {
+        const int x = position( rng ), y = position( rng ) % Height;
+        const int w = i % 4 == 0 ? 7 : size( rng ), h = i % 4 == 0 ? 7 : size( rng );
+
+        glm::ivec2 quad[] = { { x, y }, { x + w, y }, { x + w, y + h }, { x, y + h } };
+        if ( i % 2 == 1 )
+        {
+            for ( glm::ivec2& p: quad )
+                p += glm::ivec2 { jitter( rng ), jitter( rng ) };
+        }
+
+        drawQuad( rasterizer, expected, quad, texture );
+
+        // Small triangles inside of a single block, and across the corners of blocks.
+        const glm::ivec2 triangle[] = { { x, y }, { x + w % 8, y + 1 }, { x + 2, y + h % 8 } };
+        drawTriangle( rasterizer, expected, triangle, texture );
+    }
+
+    expectEqual( expected, actual );
+}
+
+// Thin and rotated triangles cover only a small part of their bounding box, so only the span of covered pixels of each
+// scanline is visited. The spans must contain exactly the pixels that pass the per-pixel test, including pixels whose
+// centers are exactly on an edge: an edge with odd x and y deltas passes through a pixel center at each half step.
+TEST(RasterizerTrianglesTest, SpansMatchPerPixelTest)
+{
+    std::mt19937                          rng( 8 );
+    std::uniform_int_distribution<int>    position( -20, Width + 20 );
+    std::uniform_int_distribution<int>    odd( -7, 7 );
+    std::uniform_int_distribution<int>    length( 1, 5 );
+    std::uniform_real_distribution<float> angle( 0.0f, 6.2831853f );
+
+    const Image texture( 1, 1, Color { 30, 20, 10, 255 } );
+
+    Image expected( Width, Height, Color::Black );
+    Image actual( Width, Height, Color::Black );
+
+    Rasterizer rasterizer;
+    rasterizer.state.colorTarget = &actual;
+    rasterizer.state.blendMode   = BlendMode::AdditiveBlend;
+    rasterizer.state.cullMode    = CullMode::None;
+
+    for ( int i = 0; i < 300; ++i )
+    {
+        const glm::ivec2 p { position( rng ), position( rng ) % Height };
+
+        // A rotated rectangle whose edges have odd deltas, so they pass through pixel centers.
+        const glm::ivec2 d { odd( rng ) | 1, odd( rng ) | 1 };
+        const glm::ivec2 u         = d * ( length( rng ) | 1 );
+        const glm::ivec2 v         = glm::ivec2 { -d.y, d.x } * ( length( rng ) | 1 );
+        const glm::ivec2 rotated[] = { p, p + u, p + u + v, p + v };
+        drawQuad( rasterizer, expected, rotated, texture );
+
+        // A thin triangle (less than 3 pixels wide) in any direction.
+        const float      a = angle( rng );
+        const glm::ivec2 l { glm::round( glm::vec2 { std::cos( a ), std::sin( a ) } * 80.0f ) };
+        const glm::ivec2 thin[] = { p, p + l, p + l + glm::ivec2 { static_cast<int>( rng() % 3 ), static_cast<int>( rng() % 3 ) } };
+        drawTriangle( rasterizer, expected, thin, texture );
+
+        // A fan of triangles around p, so the edges from p are shared by two triangles (no pixel may be drawn twice).
+        const glm::ivec2 fan[] = { p + glm::ivec2 { 9, 1 }, p + glm::ivec2 { 3, 7 }, p + glm::ivec2 { -5, 5 }, p + glm::ivec2 { -7, -3 }, p + glm::ivec2 { 1, -9 } };
+        for ( size_t j = 0; j < std::size( fan ); ++j )
+        {
+            const glm::ivec2 triangle[] = { p, fan[j], fan[( j + 1 ) % std::size( fan )] };
+            drawTriangle( rasterizer, expected, triangle, texture );
+        }
+    }
+
+    expectEqual( expected, actual );
+}
+
+// drawQuads culls and clips the quads in SIMD batches of 4. It must produce the same pixels as calling drawQuad for each
+// quad, for any number of quads (so the last batch is partial), with back-facing, degenerate, and clipped quads.
+TEST(RasterizerQuadsTest, DrawQuadsMatchesDrawQuad)
+{
+    std::mt19937                          rng( 12 );
+    std::uniform_real_distribution<float> position( -40.0f, Width + 40.0f );
+    std::uniform_real_distribution<float> offset( -30.0f, 30.0f );
+    std::uniform_real_distribution<float> texCoord( -0.5f, 1.5f );
+
+    Image texture( 16, 16 );
+    for ( int y = 0; y < 16; ++y )
+    {
+        for ( int x = 0; x < 16; ++x )
+            texture( x, y ) = Color { static_cast<uint8_t>( rng() ), static_cast<uint8_t>( rng() ), static_cast<uint8_t>( rng() ), static_cast<uint8_t>( rng() ) };
+    }
+
+    auto randomVertex = [&]( const glm::vec2& center ) {
+        return Vertex2D { center + glm::vec2 { offset( rng ), offset( rng ) }, { texCoord( rng ), texCoord( rng ) }, Color { static_cast<uint8_t>( rng() ), 255, static_cast<uint8_t>( rng() ), 200 } };
+    };
+
+    for ( size_t count: { 1, 2, 3, 4, 5, 6, 7, 13, 64 } )
+    {
+        std::vector<Vertex2D> vertices;
+        for ( size_t i = 0; i < count; ++i )
+        {
+            const glm::vec2 center { position( rng ), position( rng ) * Height / Width };
+
+            switch ( rng() % 4 )
+            {
+            case 0:  // Degenerate: all of the vertices are on a line.
+            {
+                const Vertex2D v = randomVertex( center );
+                for ( int j = 0; j < 4; ++j )
+                    vertices.emplace_back( v.position + glm::vec2 { j * 3, j * 2 }, v.texCoord, v.color );
+                break;
+            }
+            case 1:  // Outside of the color target.
+                for ( int j = 0; j < 4; ++j )
+                    vertices.push_back( randomVertex( { -100.0f, center.y } ) );
+                break;
+            default:  // Front or back-facing (random winding).
+                for ( int j = 0; j < 4; ++j )
+                    vertices.push_back( randomVertex( center ) );
+                break;
+            }
+        }
+
+        // Draw the quads in a random order with an index buffer.
+        std::vector<uint32_t> indices( vertices.size() );
+        std::iota( indices.begin(), indices.end(), 0 );
+        for ( size_t i = count; i > 1; --i )
+            std::swap_ranges( indices.begin() + ( i - 1 ) * 4, indices.begin() + i * 4, indices.begin() + ( rng() % i ) * 4 );
+
+        for ( CullMode cullMode: { CullMode::None, CullMode::Back, CullMode::Front } )
+        {
+            for ( bool frontCounterClockwise: { true, false } )
+            {
+                Image expected( Width, Height, Color::Black );
+                Image actual( Width, Height, Color::Black );
+                Image actualIndexed( Width, Height, Color::Black );
+
+                Rasterizer rasterizer;
+                rasterizer.state.blendMode             = BlendMode::AlphaBlend;
+                rasterizer.state.cullMode              = cullMode;
+                rasterizer.state.frontCounterClockwise = frontCounterClockwise;
+                rasterizer.state.viewport              = Viewport { 10.0f, 5.0f, Width - 30.0f, Height - 20.0f };
+
+                rasterizer.state.colorTarget = &expected;
+                for ( size_t i = 0; i < vertices.size(); i += 4 )
+                    rasterizer.drawQuad( vertices[i], vertices[i + 1], vertices[i + 2], vertices[i + 3], texture );
+
+                rasterizer.state.colorTarget = &actual;
+                rasterizer.drawQuads( vertices, {}, texture );
+
+                SCOPED_TRACE( ::testing::Message() << "count=" << count << " cullMode=" << static_cast<int>( cullMode ) << " frontCounterClockwise=" << frontCounterClockwise );
+                expectEqual( expected, actual );
+
+                // The same quads in a different order (the blending of overlapping quads depends on the order).
+                Image expectedIndexed( Width, Height, Color::Black );
+                rasterizer.state.colorTarget = &expectedIndexed;
+                for ( size_t i = 0; i < indices.size(); i += 4 )
+                    rasterizer.drawQuad( vertices[indices[i]], vertices[indices[i + 1]], vertices[indices[i + 2]], vertices[indices[i + 3]], texture );
+
+                rasterizer.state.colorTarget = &actualIndexed;
+                rasterizer.drawQuads( vertices, indices, texture );
+
+                expectEqual( expectedIndexed, actualIndexed );
+            }
+        }
+    }
+}
@@ -0,0 +1,136 @@
+#include <TextFilters.hpp>
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+using namespace sr;
+
+namespace
+{
+// A sparse random 8-bit image, so the windows of the filters contain both empty and set pixels.
+std::vector<uint8_t> randomImage( std::mt19937& rng, int width, int height )
+{
+    std::vector<uint8_t> image( static_cast<size_t>( width ) * height );
+    for ( uint8_t& v: image )
+        v = rng() % 4 == 0 ? static_cast<uint8_t>( rng() % 256 ) : 0;
+
+    return image;
+}
+
+// The fixed-point average that blurColumns computes for the sum of a window.
+uint8_t average( int sum, int radius )
+{
+    const int      windowSize = radius * 2 + 1;
+    const uint32_t reciprocal = ( 65536 + windowSize - 1 ) / windowSize;
+
+    return static_cast<uint8_t>( std::min( ( static_cast<uint32_t>( sum ) * reciprocal ) >> 16, 255u ) );
+}
+
+// Brute force box blur of the columns (pixels outside of the image are 0).
+std::vector<uint8_t> blurColumnsReference( const std::vector<uint8_t>& image, int width, int height, int radius )
+{
+    std::vector<uint8_t> result( image.size() );
+    for ( int y = 0; y < height; ++y )
+    {
+        for ( int x = 0; x < width; ++x )
+        {
+            int sum = 0;
+            for ( int v = std::max( y - radius, 0 ); v <= std::min( y + radius, height - 1 ); ++v )
+                sum += image[v * width + x];
+
+            result[y * width + x] = average( sum, radius );
+        }
+    }
+
+    return result;
+}
+}  // namespace
+
+TEST(TextFilterTest, Transpose)
+{
+    std::mt19937 rng( 23 );
+
+    // Sizes that are not multiples of the block size of the transpose.
+    const int                  width = 45, height = 70;
+    const std::vector<uint8_t> image = randomImage( rng, width, height );
+    std::vector<uint8_t>       transposed( image.size() );
+
+    detail::transpose( image.data(), transposed.data(), width, height );
+
+    for ( int y = 0; y < height; ++y )
+    {
+        for ( int x = 0; x < width; ++x )
+            ASSERT_EQ( transposed[x * height + y], image[y * width + x] ) << "x=" << x << " y=" << y;
+    }
+}
+
+// The separable dilation must match the maximum of the (2 * radius + 1)^2 square around each pixel.
+TEST(TextFilterTest, DilateMatchesBruteForce)
+{
+    std::mt19937 rng( 23 );
+
+    for ( int i = 0; i < 100; ++i )
+    {
+        const int width  = 1 + static_cast<int>( rng() % 70 );
+        const int height = 1 + static_cast<int>( rng() % 50 );
+        const int radius = static_cast<int>( rng() % 20 );
+
+        const std::vector<uint8_t> image   = randomImage( rng, width, height );
+        std::vector<uint8_t>       dilated = image;
+
+        detail::filterSeparable( dilated, width, height, radius, detail::dilateColumns );
+
+        for ( int y = 0; y < height; ++y )
+        {
+            for ( int x = 0; x < width; ++x )
+            {
+                uint8_t expected = 0;
+                for ( int v = std::max( y - radius, 0 ); v <= std::min( y + radius, height - 1 ); ++v )
+                {
+                    for ( int u = std::max( x - radius, 0 ); u <= std::min( x + radius, width - 1 ); ++u )
+                        expected = std::max( expected, image[v * width + u] );
+                }
+
+                ASSERT_EQ( dilated[y * width + x], expected ) << width << "x" << height << " radius=" << radius << " x=" << x << " y=" << y;
+            }
+        }
+    }
+}
+
+// The running sums of blurColumns (and its SIMD path) must match summing each window.
+TEST(TextFilterTest, BlurColumnsMatchesBruteForce)
+{
+    std::mt19937 rng( 23 );
+
+    for ( int i = 0; i < 100; ++i )
+    {
+        const int width  = 1 + static_cast<int>( rng() % 70 );
+        const int height = 1 + static_cast<int>( rng() % 50 );
+        const int radius = 1 + static_cast<int>( rng() % 20 );
+
+        const std::vector<uint8_t> image   = randomImage( rng, width, height );
+        std::vector<uint8_t>       blurred = image;
+
+        detail::blurColumns( blurred, width, height, radius );
+
+        EXPECT_EQ( blurred, blurColumnsReference( image, width, height, radius ) ) << width << "x" << height << " radius=" << radius;
+    }
+}
+
+// The sum of the largest window must not overflow, and the average of a full window of 255 must stay 255.
+TEST(TextFilterTest, BlurColumnsMaxRadius)
+{
+    const int            width = 19, height = detail::MaxBlurRadius * 2 + 1;
+    std::vector<uint8_t> image( static_cast<size_t>( width ) * height, 255 );
+
+    detail::blurColumns( image, width, height, detail::MaxBlurRadius );
+
+    // Only the center row has a full window.
+    const int center = detail::MaxBlurRadius;
+    for ( int x = 0; x < width; ++x )
+        EXPECT_EQ( image[center * width + x], 255 );
+
+    EXPECT_EQ( image, blurColumnsReference( std::vector<uint8_t>( image.size(), 255 ), width, height, detail::MaxBlurRadius ) );
+}
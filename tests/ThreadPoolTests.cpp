@@ -0,0 +1,135 @@
+#include <graphics/ThreadPool.hpp>
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+using namespace sr;
+
+namespace
+{
+// Count how many times each index of [0, count) is visited by parallelFor.
+std::vector<int> visitCounts( ThreadPool& pool, int count, int grainSize )
+{
+    std::vector<std::atomic<int>> visits( count );
+
+    parallelFor( 0, count, [&visits]( int i ) { visits[i].fetch_add( 1, std::memory_order_relaxed ); }, grainSize, pool );
+
+    std::vector<int> result( count );
+    for ( int i = 0; i < count; ++i )
+        result[i] = visits[i].load();
+
+    return result;
+}
+}  // namespace
+
+// Every index must be visited exactly once, for any grain size (including chunks that don't divide the range).
+TEST(ThreadPoolTest, ParallelForVisitsEachIndexOnce)
+{
+    ThreadPool pool( 4 );
+
+    for ( int grainSize: { 0, 1, 7, 64, 1000, 5000 } )
+    {
+        const std::vector<int> visits = visitCounts( pool, 1000, grainSize );
+
+        for ( int i = 0; i < static_cast<int>( visits.size() ); ++i )
+            ASSERT_EQ( visits[i], 1 ) << "index=" << i << " grainSize=" << grainSize;
+    }
+}
+
+TEST(ThreadPoolTest, ParallelForEmptyRange)
+{
+    ThreadPool pool( 4 );
+
+    bool called = false;
+    parallelFor( 10, 10, [&called]( int ) { called = true; }, 0, pool );
+    parallelFor( 10, 5, [&called]( int ) { called = true; }, 0, pool );
+
+    EXPECT_FALSE( called );
+}
+
+// A parallelFor inside of a job of another parallelFor must not deadlock: the waiting jobs run the pending jobs.
+TEST(ThreadPoolTest, NestedParallelFor)
+{
+    ThreadPool pool( 4 );
+
+    constexpr int    Outer = 64;
+    constexpr int    Inner = 256;
+    std::atomic<int> visits[Outer][Inner] {};
+
+    parallelFor(
+        0, Outer, [&]( int i ) {
+            parallelFor( 0, Inner, [&visits, i]( int j ) { visits[i][j].fetch_add( 1, std::memory_order_relaxed ); }, 8, pool );
+        },
+        1, pool );
+
+    for ( int i = 0; i < Outer; ++i )
+    {
+        for ( int j = 0; j < Inner; ++j )
+            ASSERT_EQ( visits[i][j].load(), 1 ) << "i=" << i << " j=" << j;
+    }
+}
+
+// A continuation runs after all jobs of the group, and wait also waits for the jobs that it runs.
+TEST(ThreadPoolTest, ThenRunsAfterAllJobs)
+{
+    ThreadPool pool( 4 );
+    TaskGroup  group( pool );
+
+    constexpr int    JobCount = 100;
+    std::atomic<int> finished = 0;
+    std::atomic<int> finishedBeforeContinuation = -1;
+    std::atomic<int> continuationJobs           = 0;
+
+    for ( int i = 0; i < JobCount; ++i )
+        group.run( [&finished] { finished.fetch_add( 1 ); } );
+
+    group.then( [&] {
+        finishedBeforeContinuation = finished.load();
+        group.run( [&continuationJobs] { continuationJobs.fetch_add( 1 ); } );
+    } );
+
+    group.wait();
+
+    EXPECT_EQ( finishedBeforeContinuation.load(), JobCount );
+    EXPECT_EQ( continuationJobs.load(), 1 );
+    EXPECT_TRUE( group.isIdle() );
+}
+
+// The continuation of an idle group runs right away.
+TEST(ThreadPoolTest, ThenOnIdleGroup)
+{
+    ThreadPool pool( 2 );
+    TaskGroup  group( pool );
+
+    std::atomic<bool> called = false;
+    group.then( [&called] { called = true; } );
+    group.wait();
+
+    EXPECT_TRUE( called.load() );
+}
+
+// A pool with a single thread has no worker threads, so all jobs run on the thread that waits for them.
+TEST(ThreadPoolTest, SingleThread)
+{
+    ThreadPool pool( 1 );
+    ASSERT_EQ( pool.getThreadCount(), 1u );
+
+    const std::thread::id caller = std::this_thread::get_id();
+    std::atomic<int>      otherThread = 0;
+
+    parallelFor( 0, 1000, [&]( int ) { otherThread += std::this_thread::get_id() != caller; }, 1, pool );
+
+    TaskGroup group( pool );
+    for ( int i = 0; i < 10; ++i )
+        group.run( [&] { otherThread += std::this_thread::get_id() != caller; } );
+    group.then( [&] { otherThread += std::this_thread::get_id() != caller; } );
+    group.wait();
+
+    EXPECT_EQ( otherThread.load(), 0 );
+
+    const std::vector<int> visits = visitCounts( pool, 100, 0 );
+    for ( int v: visits )
+        EXPECT_EQ( v, 1 );
+}